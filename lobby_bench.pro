@@ -0,0 +1,10 @@
+# Headless end-to-end benchmark of the lobby event path, see
+# tools/lobby_bench/main.cpp. Build it apart from weblobby, e.g.
+# mkdir bench && cd bench && qmake ../lobby_bench.pro && make
+include(weblobby.pri)
+
+TARGET = lobby_bench
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += tools/lobby_bench/main.cpp
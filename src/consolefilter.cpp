@@ -0,0 +1,74 @@
+#include "consolefilter.h"
+#include <algorithm>
+
+namespace {
+// Sources quiet for longer than that are forgotten, so that the next message
+// from them gets logged again.
+const std::chrono::seconds sourceExpiry(30);
+const std::size_t maxSources = 1000;
+}
+
+ConsoleFilter::ConsoleFilter(unsigned int rate, unsigned int burst) : rate(rate), burst(burst), tokens(burst),
+        lastRefill(clock::now()), suppressed(0), counters() {}
+
+bool ConsoleFilter::admit(const std::string& source, int line, const std::string& msg) {
+    counters.received++;
+    auto now = clock::now();
+    std::string key = source + ":" + std::to_string(line);
+    auto it = sources.find(key);
+    if (it != sources.end()) {
+        Source& src = it->second;
+        src.lastSeen = now;
+        if (src.lastMsg == msg) {
+            src.repeats++;
+            counters.folded++;
+            return false;
+        }
+        summarize(key, src);
+        src.lastMsg = msg;
+    } else if (sources.size() < maxSources) {
+        sources.insert(std::make_pair(key, Source { msg, 0, now }));
+    }
+
+    std::chrono::duration<double> elapsed = now - lastRefill;
+    lastRefill = now;
+    tokens = std::min(burst, tokens + elapsed.count() * rate);
+    if (tokens < 1) {
+        suppressed++;
+        counters.rateLimited++;
+        return false;
+    }
+    tokens -= 1;
+    counters.logged++;
+    return true;
+}
+
+void ConsoleFilter::summarize(const std::string& key, Source& src) {
+    if (src.repeats > 0) {
+        std::string& pending = summaries[key];
+        if (!pending.empty())
+            suppressed++;
+        pending = key + " " + src.lastMsg + " (repeated " + std::to_string(src.repeats) + " times)";
+        src.repeats = 0;
+    }
+}
+
+std::vector<std::string> ConsoleFilter::flush() {
+    auto now = clock::now();
+    for (auto it = sources.begin(); it != sources.end();) {
+        summarize(it->first, it->second);
+        if (now - it->second.lastSeen > sourceExpiry)
+            it = sources.erase(it);
+        else
+            it++;
+    }
+    std::vector<std::string> res;
+    for (auto& summary : summaries)
+        res.push_back(std::move(summary.second));
+    summaries.clear();
+    if (suppressed > 0) {
+        res.push_back(std::to_string(suppressed) + " console messages suppressed");
+        suppressed = 0;
+    }
+    return res;
+}
@@ -0,0 +1,50 @@
+#ifndef CONSOLEFILTER_H
+#define CONSOLEFILTER_H
+
+// Keeps JS console messages from flooding the log. A handler that throws for
+// every protocol line can produce thousands of identical messages a second,
+// each of which would take the logger mutex, hit the log file and post an
+// event back to the GUI thread.
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+class ConsoleFilter {
+public:
+    // At most rate messages a second are let through, with bursts of burst.
+    ConsoleFilter(unsigned int rate, unsigned int burst);
+
+    // Returns true if the message should be logged now. Repeats of the last
+    // message from the same source:line are folded instead.
+    bool admit(const std::string& source, int line, const std::string& msg);
+    // Returns "repeated N times" and "N messages suppressed" summaries of
+    // what was held back since the last call and forgets idle sources. Only
+    // the latest "repeated" summary of each source is kept, earlier ones
+    // count as suppressed.
+    std::vector<std::string> flush();
+
+    struct Stats {
+        unsigned long long received, logged, folded, rateLimited;
+    };
+    Stats stats() const { return counters; }
+private:
+    typedef std::chrono::steady_clock clock;
+    struct Source {
+        std::string lastMsg;
+        unsigned int repeats;
+        clock::time_point lastSeen;
+    };
+    void summarize(const std::string& key, Source&);
+
+    double rate, burst, tokens;
+    clock::time_point lastRefill;
+    std::map<std::string, Source> sources;
+    // Pending "repeated" summary per source.
+    std::map<std::string, std::string> summaries;
+    unsigned int suppressed;
+    Stats counters;
+};
+
+#endif // CONSOLEFILTER_H
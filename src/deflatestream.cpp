@@ -0,0 +1,80 @@
+#include "deflatestream.h"
+#include <cstring>
+
+DeflateStream::DeflateStream() {
+    std::memset(&deflater, 0, sizeof(deflater));
+    std::memset(&inflater, 0, sizeof(inflater));
+    deflateInit(&deflater, Z_DEFAULT_COMPRESSION);
+    inflateInit(&inflater);
+}
+
+DeflateStream::~DeflateStream() {
+    deflateEnd(&deflater);
+    inflateEnd(&inflater);
+}
+
+void DeflateStream::reset() {
+    deflateReset(&deflater);
+    inflateReset(&inflater);
+    lastError.clear();
+}
+
+void DeflateStream::compress(const char* data, std::size_t len, bool flush, std::string& out) {
+    deflater.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    deflater.avail_in = len;
+    int mode = flush ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+    // deflate() is done once it leaves part of the output space unused.
+    do {
+        std::size_t used = out.size();
+        out.resize(used + deflateBound(&deflater, deflater.avail_in) + 64);
+        deflater.next_out = reinterpret_cast<Bytef*>(&out[used]);
+        deflater.avail_out = out.size() - used;
+        deflate(&deflater, mode);
+        out.resize(out.size() - deflater.avail_out);
+    } while (deflater.avail_out == 0);
+}
+
+// inflate() may hold back output after consuming the last input, so this
+// goes on as long as the output space was used up.
+bool DeflateStream::decompress(const char* data, std::size_t len, LineFramer& framer,
+        std::vector<std::string>& lines) {
+    inflater.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    inflater.avail_in = len;
+    bool filled = false;
+    while (inflater.avail_in > 0 || filled) {
+        uInt availIn = inflater.avail_in;
+        if (filled)
+            framer.extract(lines);
+        auto bufs = framer.prepare();
+        std::size_t produced = 0;
+        filled = false;
+        for (auto& buf : bufs) {
+            std::size_t size = boost::asio::buffer_size(buf);
+            if (size == 0)
+                continue;
+            inflater.next_out = boost::asio::buffer_cast<Bytef*>(buf);
+            inflater.avail_out = size;
+            int ret = inflate(&inflater, Z_NO_FLUSH);
+            produced += size - inflater.avail_out;
+            filled = inflater.avail_out == 0;
+            if (ret == Z_STREAM_END) {
+                lastError = "stream ended";
+                framer.commit(produced);
+                return false;
+            }
+            if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                lastError = inflater.msg ? inflater.msg : "inflate failed";
+                framer.commit(produced);
+                return false;
+            }
+            if (inflater.avail_out > 0)
+                break;
+        }
+        framer.commit(produced);
+        if (produced == 0 && inflater.avail_in == availIn && availIn > 0) {
+            lastError = "inflate made no progress";
+            return false;
+        }
+    }
+    return true;
+}
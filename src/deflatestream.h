@@ -0,0 +1,40 @@
+#ifndef DEFLATESTREAM_H
+#define DEFLATESTREAM_H
+
+// A pair of zlib streams (RFC 1950) for a compressed lobby connection, one
+// per direction. Output is sync flushed after every batch so the peer can
+// decode everything that was sent without waiting for more.
+
+#include "lineframer.h"
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+class DeflateStream {
+public:
+    DeflateStream();
+    ~DeflateStream();
+    DeflateStream(const DeflateStream&) = delete;
+    DeflateStream& operator=(const DeflateStream&) = delete;
+
+    // Starts both streams over, for a new connection.
+    void reset();
+
+    // Compresses len bytes and appends them to out. With flush set, out
+    // afterwards holds everything compressed so far.
+    void compress(const char* data, std::size_t len, bool flush, std::string& out);
+    // Decompresses len bytes straight into framer. Whenever framer fills up
+    // its complete lines are moved to lines, so it only grows for a single
+    // line that doesn't fit and never past its maxLine. What's left is for
+    // the caller to extract. Returns false on corrupt input, error() then
+    // says what's wrong.
+    bool decompress(const char* data, std::size_t len, LineFramer& framer, std::vector<std::string>& lines);
+    // Bytes decompressed since reset(), modulo the width of uLong.
+    unsigned long decompressed() const { return inflater.total_out; }
+    const std::string& error() const { return lastError; }
+private:
+    z_stream deflater, inflater;
+    std::string lastError;
+};
+
+#endif // DEFLATESTREAM_H
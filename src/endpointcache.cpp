@@ -0,0 +1,94 @@
+#include "endpointcache.h"
+#include <sstream>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include "ufstream.h"
+
+namespace fs = boost::filesystem;
+namespace ip = boost::asio::ip;
+
+static const std::time_t maxResolvedAge = 24 * 3600;
+
+static std::string key(const std::string& host, unsigned int port) {
+    return host + ":" + std::to_string(port);
+}
+
+// Line format: host:port resolvedAt good-address|- address...
+void EndpointCache::load(const fs::path& path) {
+    this->path = path;
+    loaded = true;
+    entries.clear();
+    uifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string k, good, address;
+        Entry entry;
+        if (!(ss >> k >> entry.resolvedAt >> good))
+            continue;
+        if (good != "-")
+            entry.good = good;
+        while (ss >> address)
+            entry.addresses.push_back(address);
+        entries[k] = entry;
+    }
+}
+
+std::vector<EndpointCache::Endpoint> EndpointCache::lookup(const std::string& host, unsigned int port) const {
+    std::vector<Endpoint> res;
+    auto it = entries.find(key(host, port));
+    if (it == entries.end())
+        return res;
+    const Entry& entry = it->second;
+    boost::system::error_code ec;
+    if (!entry.good.empty()) {
+        auto address = ip::address::from_string(entry.good, ec);
+        if (!ec)
+            res.push_back(Endpoint(address, port));
+    }
+    if (std::time(NULL) - entry.resolvedAt < maxResolvedAge) {
+        for (auto& str : entry.addresses) {
+            auto address = ip::address::from_string(str, ec);
+            if (!ec && str != entry.good)
+                res.push_back(Endpoint(address, port));
+        }
+    }
+    return res;
+}
+
+void EndpointCache::storeResolved(const std::string& host, unsigned int port, const std::vector<Endpoint>& endpoints) {
+    Entry& entry = entries[key(host, port)];
+    entry.resolvedAt = std::time(NULL);
+    entry.addresses.clear();
+    for (auto& endpoint : endpoints)
+        entry.addresses.push_back(endpoint.address().to_string());
+    save();
+}
+
+void EndpointCache::markGood(const std::string& host, unsigned int port, const Endpoint& endpoint) {
+    Entry& entry = entries[key(host, port)];
+    std::string address = endpoint.address().to_string();
+    if (entry.good == address)
+        return;
+    entry.good = address;
+    save();
+}
+
+// Written to a temporary file first, a crash mustn't leave half a cache.
+void EndpointCache::save() const {
+    if (!loaded)
+        return;
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        uofstream out(tmp);
+        for (auto& e : entries) {
+            out << e.first << " " << e.second.resolvedAt << " " << (e.second.good.empty() ? "-" : e.second.good);
+            for (auto& address : e.second.addresses)
+                out << " " << address;
+            out << "\n";
+        }
+    }
+    boost::system::error_code ec;
+    fs::rename(tmp, path, ec);
+}
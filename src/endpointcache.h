@@ -0,0 +1,43 @@
+#ifndef ENDPOINTCACHE_H
+#define ENDPOINTCACHE_H
+
+// Remembers resolved addresses of lobby servers and which of them last
+// accepted a connection, so that a reconnect or the next start can begin
+// connecting before DNS has answered. Kept in a small text file, one
+// host:port per line. Only used from the network thread.
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/filesystem/path.hpp>
+
+class EndpointCache {
+public:
+    typedef boost::asio::ip::tcp::endpoint Endpoint;
+
+    EndpointCache() : loaded(false) {}
+
+    void load(const boost::filesystem::path&);
+    // The last good endpoint of host:port followed by its resolved addresses.
+    // Resolved addresses expire after a day, the last good one doesn't.
+    std::vector<Endpoint> lookup(const std::string& host, unsigned int port) const;
+    void storeResolved(const std::string& host, unsigned int port, const std::vector<Endpoint>&);
+    void markGood(const std::string& host, unsigned int port, const Endpoint&);
+private:
+    void save() const;
+
+    struct Entry {
+        Entry() : resolvedAt(0) {}
+        std::time_t resolvedAt;
+        std::string good;
+        std::vector<std::string> addresses;
+    };
+    // Keyed by host:port.
+    std::map<std::string, Entry> entries;
+    boost::filesystem::path path;
+    bool loaded;
+};
+
+#endif // ENDPOINTCACHE_H
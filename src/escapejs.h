@@ -0,0 +1,153 @@
+#ifndef ESCAPEJS_H
+#define ESCAPEJS_H
+
+// Escaping of strings for use inside JS string literals. The input is scanned
+// 16 bytes at a time for the few characters that need escaping, clean runs are
+// copied in bulk and the output is sized exactly before anything is written,
+// so escaping into a reused buffer doesn't allocate at all.
+// U+2028 and U+2029 (UTF-8 E2 80 A8/A9) end a line inside a JS string literal
+// just like '\n', one of them in a chat line would make a whole batch of
+// calls a SyntaxError. They're written as \u2028 and \u2029.
+
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+namespace escapejs {
+
+// The character that follows the backslash, 0 if c is fine as is.
+inline char escapeChar(unsigned char c) {
+    static const struct Table {
+        char t[256];
+        Table() : t() {
+            t['\''] = '\'';
+            t['\\'] = '\\';
+            t['"'] = '"';
+            t['\n'] = 'n';
+            t['\r'] = 'r';
+        }
+    } table;
+    return table.t[c];
+}
+
+// Whether str, len bytes before its end, starts with U+2028 or U+2029.
+inline bool isLineSeparator(const char* str, std::size_t len) {
+    return len >= 3 && (unsigned char)str[0] == 0xE2 && (unsigned char)str[1] == 0x80 &&
+        ((unsigned char)str[2] & 0xFE) == 0xA8;
+}
+
+// How many bytes escaping the character at str adds.
+inline std::size_t extraBytes(const char* str, std::size_t len) {
+    if (escapeChar(*str))
+        return 1;
+    return isLineSeparator(str, len) ? 3 : 0;
+}
+
+#ifdef __SSE2__
+// Bit i is set if p[i] needs escaping or may start a line separator.
+inline unsigned specialMask(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\'')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\xE2'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+    return (unsigned)_mm_movemask_epi8(m);
+}
+#endif
+
+// Number of bytes escaping str adds.
+inline std::size_t countSpecial(const char* str, std::size_t len) {
+    std::size_t n = 0, i = 0;
+    #ifdef __SSE2__
+        for (; i + 16 <= len; i += 16) {
+            for (unsigned mask = specialMask(str + i); mask; mask &= mask - 1) {
+                std::size_t at = i + __builtin_ctz(mask);
+                n += extraBytes(str + at, len - at);
+            }
+        }
+    #endif
+    for (; i < len; i++)
+        n += extraBytes(str + i, len - i);
+    return n;
+}
+
+// Writes the escape of the character at str to dst, returns how many input
+// bytes it took, 0 if it needs none.
+inline std::size_t writeEscape(char*& dst, const char* str, std::size_t len) {
+    if (char e = escapeChar(*str)) {
+        *dst++ = '\\';
+        *dst++ = e;
+        return 1;
+    }
+    if (!isLineSeparator(str, len))
+        return 0;
+    std::memcpy(dst, str[2] == '\xA8' ? "\\u2028" : "\\u2029", 6);
+    dst += 6;
+    return 3;
+}
+
+// Appends the escaped str to out.
+inline void append(std::string& out, const char* str, std::size_t len) {
+    std::size_t special = countSpecial(str, len);
+    std::size_t pos = out.size();
+    out.resize(pos + len + special);
+    char* dst = &out[0] + pos;
+    if (special == 0) {
+        std::memcpy(dst, str, len);
+        return;
+    }
+
+    // run is the start of the pending clean run. The bytes of a separator
+    // never match, the scan may still go on inside one.
+    std::size_t i = 0, run = 0;
+    auto escapeAt = [&](std::size_t at) {
+        if (at < run)
+            return;
+        char* escaped = dst + (at - run);
+        if (std::size_t used = writeEscape(escaped, str + at, len - at)) {
+            std::memcpy(dst, str + run, at - run);
+            dst = escaped;
+            run = at + used;
+        }
+    };
+    #ifdef __SSE2__
+        for (; i + 16 <= len; i += 16) {
+            for (unsigned mask = specialMask(str + i); mask; mask &= mask - 1)
+                escapeAt(i + __builtin_ctz(mask));
+        }
+    #endif
+    for (; i < len; i++)
+        escapeAt(i);
+    std::memcpy(dst, str + run, len - run);
+}
+
+inline void append(std::string& out, const std::string& str) {
+    append(out, str.data(), str.size());
+}
+
+// A number as a JS literal. JS has no literal for infinities and NaN, they
+// become null like in JSON. 17 digits read back as the same double.
+inline void appendNumber(std::string& out, double d) {
+    if (!std::isfinite(d)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.17g", d);
+    out.append(buf, n);
+}
+
+inline std::string escape(const std::string& str) {
+    std::string res;
+    append(res, str);
+    return res;
+}
+
+} // namespace escapejs
+
+#endif // ESCAPEJS_H
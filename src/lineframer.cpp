@@ -0,0 +1,105 @@
+#include "lineframer.h"
+#include <cstring>
+
+LineFramer::LineFramer(std::size_t capacity, std::size_t maxLine, bool anyNewline) : maxLine(maxLine),
+        anyNewline(anyNewline), afterCr(false), head(0), size(0), scanned(0) {
+    std::size_t cap = 4096;
+    while (cap < capacity)
+        cap *= 2;
+    buf.resize(cap);
+    mask = cap - 1;
+}
+
+std::array<boost::asio::mutable_buffer, 2> LineFramer::prepare() {
+    if (size == buf.size())
+        grow();
+    std::size_t cap = buf.size(), tail = (head + size) & mask, free = cap - size;
+    std::size_t first = std::min(free, cap - tail);
+    return {{ boost::asio::buffer(&buf[tail], first), boost::asio::buffer(&buf[0], free - first) }};
+}
+
+void LineFramer::commit(std::size_t n) {
+    size += n;
+}
+
+std::size_t LineFramer::extract(std::vector<std::string>& lines, std::size_t max) {
+    std::size_t count = 0;
+    while (count < max) {
+        if (afterCr && size > 0) {
+            afterCr = false;
+            if (buf[head] == '\n') {
+                head = (head + 1) & mask;
+                size--;
+            }
+        }
+        std::size_t pos = scan(scanned, size);
+        if (pos == std::string::npos) {
+            scanned = size;
+            // A line that doesn't fit even into maxLine bytes is cut.
+            if (size == buf.size() && size >= maxLine) {
+                lines.emplace_back();
+                take(size, lines.back());
+                count++;
+            }
+            break;
+        }
+        lines.emplace_back();
+        take(pos + 1, lines.back());
+        afterCr = lines.back().back() == '\r';
+        lines.back().pop_back();
+        count++;
+    }
+    return count;
+}
+
+void LineFramer::drain(std::string& out) {
+    take(size, out);
+}
+
+void LineFramer::reset() {
+    head = size = scanned = 0;
+    afterCr = false;
+}
+
+// Only called with a full buffer, the data is linearized into one twice as big.
+void LineFramer::grow() {
+    std::vector<char> bigger(buf.size() * 2);
+    std::size_t first = std::min(size, buf.size() - head);
+    std::memcpy(&bigger[0], &buf[head], first);
+    std::memcpy(&bigger[first], &buf[0], size - first);
+    buf.swap(bigger);
+    mask = buf.size() - 1;
+    head = 0;
+}
+
+// Offset of the first line end in [from, to) relative to head, or npos.
+// memchr is vectorized by any decent libc.
+std::size_t LineFramer::scan(std::size_t from, std::size_t to) const {
+    while (from < to) {
+        std::size_t p = (head + from) & mask;
+        std::size_t len = std::min(to - from, buf.size() - p);
+        const char* found = static_cast<const char*>(std::memchr(&buf[p], '\n', len));
+        if (anyNewline) {
+            const char* cr = static_cast<const char*>(std::memchr(&buf[p], '\r', found ? found - &buf[p] : len));
+            if (cr)
+                found = cr;
+        }
+        if (found)
+            return from + (found - &buf[p]);
+        from += len;
+    }
+    return std::string::npos;
+}
+
+// Moves the first len bytes into out.
+void LineFramer::take(std::size_t len, std::string& out) {
+    std::size_t first = std::min(len, buf.size() - head);
+    out.reserve(len);
+    out.assign(&buf[head], first);
+    out.append(&buf[0], len - first);
+    head = (head + len) & mask;
+    size -= len;
+    scanned = 0;
+    if (size == 0)
+        head = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef LINEFRAMER_H
+#define LINEFRAMER_H
+
+// Splits a byte stream into '\n' terminated lines. Data is read straight into
+// a ring buffer in large chunks and every complete line of a chunk is taken
+// out at once. A partial line at the end of a chunk stays where it is until
+// the rest of it arrives.
+
+#include <array>
+#include <string>
+#include <vector>
+#include <boost/asio/buffer.hpp>
+
+class LineFramer {
+public:
+    // capacity is rounded up to a power of two. The buffer grows when a
+    // single line doesn't fit, up to maxLine bytes, longer lines are split.
+    // With anyNewline a lone '\r' ends a line too and "\r\n" counts as one
+    // line end, which is what progress bars of child processes need.
+    explicit LineFramer(std::size_t capacity = 65536, std::size_t maxLine = 16 << 20, bool anyNewline = false);
+
+    // The free space of the buffer, pass it to async_read_some().
+    std::array<boost::asio::mutable_buffer, 2> prepare();
+    // Marks n bytes of the space returned by prepare() as received.
+    void commit(std::size_t n);
+    // Appends up to max complete lines received so far to lines, without
+    // the '\n'. Returns the number of lines appended.
+    std::size_t extract(std::vector<std::string>& lines, std::size_t max = std::size_t(-1));
+    // Moves out everything buffered, complete lines or not.
+    void drain(std::string& out);
+    // Drops everything buffered, e.g. after a reconnect.
+    void reset();
+
+    std::size_t buffered() const { return size; }
+private:
+    void grow();
+    std::size_t scan(std::size_t from, std::size_t to) const;
+    void take(std::size_t len, std::string& out);
+
+    std::vector<char> buf;
+    std::size_t mask, maxLine;
+    bool anyNewline;
+    // The last line ended with '\r', a '\n' right after it belongs to it.
+    bool afterCr;
+    // Start of the unconsumed data, number of bytes held and how many of
+    // those are already known not to contain a '\n'.
+    std::size_t head, size, scanned;
+};
+
+#endif // LINEFRAMER_H
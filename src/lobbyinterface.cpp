@@ -26,7 +26,8 @@ namespace fs = boost::filesystem;
 
 LobbyInterface::LobbyInterface(QObject *parent, QWebFrame *frame) :
         QObject(parent), springHome(""), debugNetwork(false), debugCommands(false),
-        network(this, logger), frame(frame) {
+        network(this, logger), frame(frame), batchMaxItems(1000), batchMaxDelay(0), consoleFilter(20, 100),
+        reaper(logger), commandUsageLog(false), nextProbeId(1) {
     logger.setEventReceiver(this);
     auto args = QCoreApplication::arguments();
     if (args.contains("-debug-all")) {
@@ -43,6 +44,29 @@ LobbyInterface::LobbyInterface(QObject *parent, QWebFrame *frame) :
     }
     if (args.contains("-debug"))
         logger.setDebug(true);
+    int argIndex = args.indexOf("-batch-max-items");
+    if (argIndex >= 0 && argIndex + 1 < args.length())
+        batchMaxItems = args[argIndex+1].toInt();
+    argIndex = args.indexOf("-batch-max-delay");
+    if (argIndex >= 0 && argIndex + 1 < args.length())
+        batchMaxDelay = args[argIndex+1].toInt();
+    setEventBatching(batchMaxItems, batchMaxDelay);
+    unsigned int stallThreshold = 1000;
+    argIndex = args.indexOf("-stall-threshold");
+    if (argIndex >= 0 && argIndex + 1 < args.length())
+        stallThreshold = args[argIndex+1].toUInt();
+    watchdog.reset(new StallWatchdog(logger, stallThreshold));
+    if (stallThreshold > 0) {
+        QObject::connect(&heartbeatTimer, &QTimer::timeout, [=](){ watchdog->heartbeat(); });
+        heartbeatTimer.start(std::max(stallThreshold / 4, 10u));
+    }
+
+    batchTimer.setSingleShot(true);
+    // Plain connect() would be our own slot.
+    QObject::connect(&batchTimer, &QTimer::timeout, this, &LobbyInterface::flushJs);
+    QObject::connect(&perfStatsTimer, &QTimer::timeout, this, &LobbyInterface::writePerfStats);
+    QObject::connect(&consoleFilterTimer, &QTimer::timeout, this, &LobbyInterface::flushConsoleFilter);
+    consoleFilterTimer.start(5000);
 
     #if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
         char buf[1024];
@@ -60,7 +84,7 @@ LobbyInterface::LobbyInterface(QObject *parent, QWebFrame *frame) :
 }
 
 LobbyInterface::~LobbyInterface() {
-    network.disconnect();
+    network.disconnectAll();
     for (auto it = downloadThreads.begin(); it != downloadThreads.end(); it++) {
         if (it->joinable())
             it->join();
@@ -95,6 +119,7 @@ void LobbyInterface::move(const fs::path& src, const fs::path& dst) {
 }
 
 void LobbyInterface::init() {
+    Activity activity("init");
     #if defined Q_OS_LINUX
         os = "Linux";
     #elif defined Q_OS_WIN32 // Defined on 64-bit Windows too.
@@ -131,6 +156,15 @@ void LobbyInterface::init() {
         fs::create_directories(weblobbyDir / "logs");
         frame->page()->settings()->setLocalStoragePath(QString::fromStdWString(weblobbyDir.wstring() + L"/storage"));
         logger.setLogFile(weblobbyDir / "weblobby.log");
+        if (Trace::enabled() && Trace::dumpPath().empty()) {
+            char date[32];
+            time_t t = std::time(NULL);
+            std::strftime(date, sizeof(date), "%Y%m%d-%H%M%S", std::localtime(&t));
+            Trace::setDumpPath(weblobbyDir / "logs" / (std::string("trace-") + date + ".json"));
+            logger.info("Trace will be written to ", Trace::dumpPath());
+        }
+        perfStatsTimer.start(15000);
+        network.setCachePath(weblobbyDir / "endpoints.cache");
 
         auto args = QCoreApplication::arguments();
         int argIndex = args.indexOf("-prepackaged-data");
@@ -180,55 +214,520 @@ void LobbyInterface::writeSpringHomeSetting(QString path) {
     out << "springHome:" << toStdString(springHomeSetting.wstring()) << std::endl;
 }
 
+static NetworkHandler::ConnectOptions toConnectOptions(QVariantMap options) {
+    NetworkHandler::ConnectOptions opts;
+    opts.compress = options["compress"].toBool();
+    opts.reconnect = options["reconnect"].toBool();
+    opts.tokenize = options["tokenize"].toBool();
+    opts.batchLogin = options["batchLogin"].toBool();
+    opts.mirrorState = options["mirrorState"].toBool();
+    opts.stateDiffInterval = options["stateDiffInterval"].toUInt();
+    return opts;
+}
+
+static QVariantList toVariant(const std::vector<std::string>& strings) {
+    QVariantList res;
+    res.reserve(strings.size());
+    for (auto& str : strings)
+        res.append(QString::fromStdString(str));
+    return res;
+}
+
+// { lines: n, commands: { ADDUSER: { seq: [...], columns: [[...], ...] }, ... } }
+static QVariantMap toVariant(const LoginBatch& batch) {
+    QVariantMap commands;
+    for (auto& entry : batch.tables) {
+        QVariantList seq, columns;
+        seq.reserve(entry.second.seq.size());
+        for (unsigned int i : entry.second.seq)
+            seq.append(i);
+        for (auto& column : entry.second.columns)
+            columns.append(toVariant(column));
+        QVariantMap table;
+        table["seq"] = seq;
+        table["columns"] = columns;
+        commands[QString::fromStdString(entry.first)] = table;
+    }
+    QVariantMap res;
+    res["lines"] = batch.lines;
+    res["commands"] = commands;
+    return res;
+}
+
+static QVariantMap toVariant(const NetworkHandler::SendStats& stats) {
+    QVariantMap res;
+    res["queuedMessages"] = stats.queuedMessages;
+    res["queuedBytes"] = stats.queuedBytes;
+    res["inFlightBytes"] = stats.inFlightBytes;
+    res["sentMessages"] = stats.sentMessages;
+    res["sentBytes"] = stats.sentBytes;
+    res["pacedWaits"] = stats.pacedWaits;
+    return res;
+}
+
+static QVariantMap toVariant(const NetworkHandler::TransportStats& stats) {
+    QVariantMap res;
+    res["compressed"] = stats.compressed;
+    res["bytesIn"] = stats.bytesIn;
+    res["wireBytesIn"] = stats.wireBytesIn;
+    res["bytesOut"] = stats.bytesOut;
+    res["wireBytesOut"] = stats.wireBytesOut;
+    return res;
+}
+
+static QVariantMap toVariant(const NetworkHandler::ConnectStats& stats) {
+    QVariantMap res;
+    res["connects"] = stats.connects;
+    res["failures"] = stats.failures;
+    res["reconnects"] = stats.reconnects;
+    res["lastConnectMs"] = stats.lastConnectUs / 1000.0;
+    res["lastResolveMs"] = stats.lastResolveUs / 1000.0;
+    res["lastEndpointsTried"] = stats.lastEndpointsTried;
+    res["lastFromCache"] = stats.lastFromCache;
+    res["lastEndpoint"] = QString::fromStdString(stats.lastEndpoint);
+    return res;
+}
+
+static QVariantMap toVariant(const NetworkHandler::LinkStats& stats) {
+    QVariantMap res;
+    res["lastRttMs"] = stats.lastRttUs / 1000.0;
+    res["minRttMs"] = stats.minRttUs / 1000.0;
+    res["meanRttMs"] = stats.meanRttUs / 1000.0;
+    res["p50RttMs"] = stats.p50RttUs / 1000.0;
+    res["p99RttMs"] = stats.p99RttUs / 1000.0;
+    res["maxRttMs"] = stats.maxRttUs / 1000.0;
+    res["jitterMs"] = stats.jitterUs / 1000.0;
+    res["samples"] = stats.samples;
+    res["pingsSent"] = stats.pingsSent;
+    res["pongsReceived"] = stats.pongsReceived;
+    res["pingsLost"] = stats.pingsLost;
+    res["stalls"] = stats.stalls;
+    return res;
+}
+
+static QVariant usageMs(long long us) {
+    return us < 0 ? -1.0 : us / 1000.0;
+}
+
+static QVariantMap toVariant(const ProcessReaper::Usage& usage) {
+    QVariantMap res;
+    res["wallMs"] = usageMs(usage.wallUs);
+    res["userMs"] = usageMs(usage.userUs);
+    res["systemMs"] = usageMs(usage.systemUs);
+    res["maxRssKb"] = qlonglong(usage.maxRssKb);
+    res["majorFaults"] = qlonglong(usage.majorFaults);
+    res["readBytes"] = qlonglong(usage.readBytes);
+    res["writeBytes"] = qlonglong(usage.writeBytes);
+    res["diskReadBytes"] = qlonglong(usage.diskReadBytes);
+    res["diskWriteBytes"] = qlonglong(usage.diskWriteBytes);
+    return res;
+}
+
+template<class Row> static QVariantMap stateRow(const Row& row) {
+    QVariantMap res;
+    for (auto& field : LobbyState::fields<Row>()) {
+        LobbyState::Value val = field.get(row);
+        if (val.isString)
+            res[field.name] = QString::fromStdString(val.str);
+        else
+            res[field.name] = val.num;
+    }
+    return res;
+}
+
+static QVariantMap toVariant(const LobbyState::User& user) {
+    return stateRow(user);
+}
+
+static QVariantMap toVariant(const LobbyState::Battle& battle) {
+    QVariantMap res = stateRow(battle);
+    res["members"] = toVariant(battle.members);
+    return res;
+}
+
+static QVariantMap toVariant(const LobbyState::Channel& channel) {
+    QVariantMap res = stateRow(channel);
+    res["users"] = toVariant(std::vector<std::string>(channel.users.begin(), channel.users.end()));
+    return res;
+}
+
+template<class Row> static QVariantList toVariant(const std::vector<Row>& rows) {
+    QVariantList res;
+    res.reserve(rows.size());
+    for (auto& row : rows)
+        res.append(toVariant(row));
+    return res;
+}
+
+static QVariantMap toVariant(const LobbyState::Diff& diff) {
+    QVariantMap res;
+    res["cleared"] = diff.cleared;
+    res["users"] = toVariant(diff.users);
+    res["battles"] = toVariant(diff.battles);
+    res["channels"] = toVariant(diff.channels);
+    res["removedUsers"] = toVariant(diff.removedUsers);
+    res["removedChannels"] = toVariant(diff.removedChannels);
+    QVariantList removedBattles;
+    for (long long id : diff.removedBattles)
+        removedBattles.append(id);
+    res["removedBattles"] = removedBattles;
+    return res;
+}
+
+static LobbyState::Value toStateValue(const QVariant& val) {
+    if (val.type() == QVariant::String)
+        return LobbyState::Value(val.toString().toStdString());
+    return LobbyState::Value(val.toLongLong());
+}
+
 void LobbyInterface::connect(QString host, unsigned int port) {
-    network.connect(host.toStdString(), port);
+    network.connect("", host.toStdString(), port);
+}
+
+void LobbyInterface::connect(QString host, unsigned int port, QVariantMap options) {
+    network.connect("", host.toStdString(), port, toConnectOptions(options));
 }
 
 void LobbyInterface::disconnect() {
-    network.disconnect();
+    network.disconnect("");
 }
 
 void LobbyInterface::send(QString msg) {
-    network.send(msg.toStdString());
+    network.send("", msg.toStdString());
+}
+
+void LobbyInterface::connectNamed(QString name, QString host, unsigned int port, QVariantMap options) {
+    network.connect(name.toStdString(), host.toStdString(), port, toConnectOptions(options));
+}
+
+void LobbyInterface::disconnectNamed(QString name) {
+    network.disconnect(name.toStdString());
+}
+
+void LobbyInterface::sendNamed(QString name, QString msg) {
+    network.send(name.toStdString(), msg.toStdString());
+}
+
+QStringList LobbyInterface::getConnections() {
+    QStringList res;
+    for (auto& name : network.connectionNames()) {
+        if (!name.empty())
+            res.append(QString::fromStdString(name));
+    }
+    return res;
+}
+
+QVariantMap LobbyInterface::getConnectionStats(QString name) {
+    std::string conn = name.toStdString();
+    QVariantMap res;
+    res["send"] = toVariant(network.sendStats(conn));
+    res["transport"] = toVariant(network.transportStats(conn));
+    res["connect"] = toVariant(network.connectStats(conn));
+    res["link"] = toVariant(network.linkStats(conn));
+    if (auto state = network.lobbyState(conn)) {
+        LobbyState::Stats stats = state->stats();
+        QVariantMap stateStats;
+        stateStats["users"] = (unsigned long long)stats.users;
+        stateStats["battles"] = (unsigned long long)stats.battles;
+        stateStats["channels"] = (unsigned long long)stats.channels;
+        stateStats["applied"] = stats.applied;
+        res["state"] = stateStats;
+    }
+    return res;
+}
+
+QString LobbyInterface::startCapture(QString name) {
+    char date[32];
+    time_t t = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y%m%d-%H%M%S", std::localtime(&t));
+    std::string file = std::string("capture-") + date + (name.isEmpty() ? "" : "-" + name.toStdString()) + ".wlcap";
+    network.startCapture(name.toStdString(), springHome / "weblobby" / "logs" / file);
+    return QString::fromStdString(file);
+}
+
+void LobbyInterface::stopCapture(QString name) {
+    network.stopCapture(name.toStdString());
+}
+
+void LobbyInterface::replayCapture(QString name, QString path, QVariantMap options) {
+    fs::path capture = path.toStdWString();
+    if (capture.is_relative())
+        capture = springHome / "weblobby" / "logs" / capture;
+    double speed = options.contains("speed") ? options["speed"].toDouble() : 1.0;
+    std::string conn = name.toStdString();
+    replays[conn] = ReplayRun();
+    replays[conn].start = PerfStats::clock::now();
+    network.replay(conn, capture, toConnectOptions(options), std::max(speed, 0.0));
+}
+
+QVariantMap LobbyInterface::getReplayStats() {
+    return lastReplayStats;
+}
+
+QVariantMap LobbyInterface::getProtocolProfile(QString name, int topN) {
+    QVariantMap res, commands;
+    QVariantList top;
+    auto profiler = network.protocolProfiler(name.toStdString());
+    if (profiler) {
+        auto stats = profiler->commands();
+        for (auto& entry : stats) {
+            const ProtocolProfiler::CommandStats& s = entry.second;
+            QVariantMap cmd;
+            cmd["inMessages"] = s.messages[ProtocolProfiler::in];
+            cmd["inBytes"] = s.bytes[ProtocolProfiler::in];
+            cmd["outMessages"] = s.messages[ProtocolProfiler::out];
+            cmd["outBytes"] = s.bytes[ProtocolProfiler::out];
+            cmd["parsed"] = s.parsed;
+            cmd["parseMs"] = std::chrono::duration<double, std::milli>(s.parseTime).count();
+            cmd["dispatched"] = s.dispatched;
+            cmd["convertMs"] = std::chrono::duration<double, std::milli>(s.convertTime).count();
+            cmd["jsShareMs"] = std::chrono::duration<double, std::milli>(s.jsShareTime).count();
+            commands[QString::fromStdString(entry.first)] = cmd;
+        }
+        for (auto& rates : profiler->top(std::max(topN, 0))) {
+            QVariantMap entry, windows;
+            entry["command"] = QString::fromStdString(rates.command);
+            for (int w = 0; w < 3; w++) {
+                QVariantMap window;
+                window["messagesPerSec"] = rates.messages[w];
+                window["bytesPerSec"] = rates.bytes[w];
+                windows[QString::number(ProtocolProfiler::windows[w])] = window;
+            }
+            entry["windows"] = windows;
+            top.append(entry);
+        }
+    }
+    res["commands"] = commands;
+    res["top"] = top;
+    return res;
+}
+
+QVariantMap LobbyInterface::queryLobbyState(QString table, QVariantMap query) {
+    QVariantMap res;
+    res["total"] = 0;
+    res["rows"] = QVariantList();
+    auto state = network.lobbyState(query["connection"].toString().toStdString());
+    if (!state)
+        return res;
+    LobbyState::Query q;
+    QVariantMap where = query["where"].toMap();
+    for (auto it = where.begin(); it != where.end(); ++it)
+        q.where.push_back(std::make_pair(it.key().toStdString(), toStateValue(it.value())));
+    q.search = query["search"].toString().toStdString();
+    q.sortBy = query["sortBy"].toString().toStdString();
+    q.descending = query["descending"].toBool();
+    q.offset = query["offset"].toUInt();
+    if (query.contains("limit"))
+        q.limit = query["limit"].toUInt();
+    std::size_t total = 0;
+    if (table == "users")
+        res["rows"] = toVariant(state->users(q, total));
+    else if (table == "battles")
+        res["rows"] = toVariant(state->battles(q, total));
+    else if (table == "channels")
+        res["rows"] = toVariant(state->channels(q, total));
+    else
+        logger.warning("queryLobbyState(): unknown table: ", table.toStdString());
+    res["total"] = (unsigned long long)total;
+    return res;
+}
+
+void LobbyInterface::setSendPacing(unsigned int rate, unsigned int burst) {
+    network.setPacing(rate, burst);
+}
+
+QVariantMap LobbyInterface::getSendQueueStats() {
+    return toVariant(network.sendStats(""));
+}
+
+QVariantMap LobbyInterface::getTransportStats() {
+    return toVariant(network.transportStats(""));
+}
+
+QVariantMap LobbyInterface::getConnectStats() {
+    return toVariant(network.connectStats(""));
+}
+
+void LobbyInterface::setLinkMonitor(unsigned int interval, unsigned int stallWindow) {
+    network.setLinkMonitor(interval, stallWindow);
+}
+
+QVariantMap LobbyInterface::getLinkStats() {
+    return toVariant(network.linkStats(""));
+}
+
+static const char* eventTypeName(int type) {
+    if (type == NetworkHandler::ReadEvent::TypeId) return "network_read";
+    if (type == NetworkHandler::ErrorEvent::TypeId) return "network_error";
+    if (type == NetworkHandler::StateDiffEvent::TypeId) return "state_diff";
+    if (type == NetworkHandler::ReplayDoneEvent::TypeId) return "replay_done";
+    if (type == NetworkHandler::ProbeEvent::TypeId) return "udp_probe";
+    if (type == Logger::LogEvent::TypeId) return "log";
+    if (type == ProcessRunner::ReadEvent::TypeId) return "process_read";
+    if (type == ProcessRunner::TerminateEvent::TypeId) return "process_terminate";
+    if (type == UnitsyncHandlerAsync::ResultEvent::TypeId) return "unitsync_result";
+    if (type == LobbyInterface::DownloadEvent::TypeId) return "download";
+    return "unknown";
 }
 
 bool LobbyInterface::event(QEvent* evt) {
-    if (evt->type() == NetworkHandler::ReadEvent::TypeId) {
-        auto readEvt = dynamic_cast<NetworkHandler::ReadEvent&>(*evt);
-        evalJs("on_socket_get('" + escapeJs(readEvt.msg) + "')");
-        return true;
-    } else if (evt->type() == NetworkHandler::ErrorEvent::TypeId) {
-        auto errorEvt = dynamic_cast<NetworkHandler::ErrorEvent&>(*evt);
-        evalJs("on_socket_error('" + escapeJs(errorEvt.reason) + "')");
-        return true;
-    } else if (evt->type() == Logger::LogEvent::TypeId) {
-        auto logEvt = dynamic_cast<Logger::LogEvent&>(*evt);
+    if (!isNativeEvent(evt))
+        return QObject::event(evt);
+    auto& nativeEvt = static_cast<NativeEvent&>(*evt);
+    Activity activity(eventTypeName(evt->type()));
+    auto start = PerfStats::clock::now();
+    handleNativeEvent(nativeEvt);
+    perfStats.recordEvent(evt->type(), eventTypeName(evt->type()), nativeEvt.postTime, start, PerfStats::clock::now());
+    return true;
+}
+
+// TypeIds are known at compile time, so the events are told apart with a
+// switch and static_cast, no RTTI involved.
+void LobbyInterface::handleNativeEvent(NativeEvent& evt) {
+    switch (int(evt.type())) {
+    case NetworkHandler::ReadEvent::TypeId: {
+        auto& readEvt = static_cast<NetworkHandler::ReadEvent&>(evt);
+        // Lines are timed up to queueJs(), which may flush the batch.
+        QString name = QString::fromStdString(readEvt.connection);
+        for (auto& line : readEvt.lines) {
+            auto start = PerfStats::clock::now();
+            QString qline = QString::fromStdString(line);
+            if (readEvt.profiler) {
+                ProfiledLine profiled = { readEvt.profiler, ProtocolProfiler::commandOf(line),
+                    PerfStats::clock::now() - start };
+                profiledLines.push_back(profiled);
+            }
+            if (readEvt.connection.empty())
+                queueJs("on_socket_get", { qline });
+            else
+                queueJs("on_named_socket_get", { name, qline });
+        }
+        for (auto& cmd : readEvt.commands) {
+            auto start = PerfStats::clock::now();
+            QString command = QString::fromStdString(cmd.command), id = QString::fromStdString(cmd.id);
+            QVariantList args = toVariant(cmd.args);
+            if (readEvt.profiler) {
+                ProfiledLine profiled = { readEvt.profiler, cmd.command, PerfStats::clock::now() - start };
+                profiledLines.push_back(profiled);
+            }
+            if (readEvt.connection.empty())
+                queueJs("on_socket_command", { command, args, id });
+            else
+                queueJs("on_named_socket_command", { name, command, args, id });
+        }
+        if (!replays.empty() && replays.count(readEvt.connection)) {
+            std::size_t lines = readEvt.lines.size() + readEvt.commands.size() + (readEvt.batch ? readEvt.batch->lines : 0);
+            ReplayedEvent replayed = { readEvt.connection, readEvt.postTime, lines };
+            replayedEvents.push_back(replayed);
+        }
+        if (readEvt.batch) {
+            if (readEvt.connection.empty())
+                queueJs("on_socket_login_batch", { toVariant(*readEvt.batch) });
+            else
+                queueJs("on_named_socket_login_batch", { QString::fromStdString(readEvt.connection),
+                    toVariant(*readEvt.batch) });
+        }
+        break;
+    }
+    case NetworkHandler::ErrorEvent::TypeId: {
+        auto& errorEvt = static_cast<NetworkHandler::ErrorEvent&>(evt);
+        if (errorEvt.connection.empty())
+            queueJs("on_socket_error", { QString::fromStdString(errorEvt.reason) });
+        else
+            queueJs("on_named_socket_error", { QString::fromStdString(errorEvt.connection),
+                QString::fromStdString(errorEvt.reason) });
+        break;
+    }
+    case NetworkHandler::StateDiffEvent::TypeId: {
+        auto& diffEvt = static_cast<NetworkHandler::StateDiffEvent&>(evt);
+        if (diffEvt.connection.empty())
+            queueJs("on_state_diff", { toVariant(diffEvt.diff) });
+        else
+            queueJs("on_named_state_diff", { QString::fromStdString(diffEvt.connection), toVariant(diffEvt.diff) });
+        break;
+    }
+    case NetworkHandler::ProbeEvent::TypeId: {
+        auto& probeEvt = static_cast<NetworkHandler::ProbeEvent&>(evt);
+        QVariantList results;
+        for (auto& result : probeEvt.results) {
+            QVariantMap res;
+            res["host"] = QString::fromStdString(result.host);
+            res["port"] = result.port;
+            res["status"] = UdpProber::statusName(result.status);
+            res["rttMs"] = result.rttUs < 0 ? -1.0 : result.rttUs / 1000.0;
+            res["cached"] = result.cached;
+            if (!result.error.empty())
+                res["error"] = QString::fromStdString(result.error);
+            results.append(res);
+        }
+        queueJs("on_probe_results", { probeEvt.id, results, probeEvt.done });
+        break;
+    }
+    case NetworkHandler::ReplayDoneEvent::TypeId: {
+        auto& doneEvt = static_cast<NetworkHandler::ReplayDoneEvent&>(evt);
+        // Everything before this event is already queued, flushing gets the
+        // last latencies in.
+        flushJs();
+        auto it = replays.find(doneEvt.connection);
+        if (it == replays.end())
+            break;
+        QVariantMap stats;
+        if (doneEvt.error.empty()) {
+            double elapsedMs = std::chrono::duration_cast<std::chrono::microseconds>(
+                PerfStats::clock::now() - it->second.start).count() / 1000.0;
+            stats["lines"] = doneEvt.stats.lines;
+            stats["bytes"] = doneEvt.stats.bytes;
+            stats["feedMs"] = doneEvt.stats.feedUs / 1000.0;
+            stats["elapsedMs"] = elapsedMs;
+            stats["linesPerSec"] = elapsedMs > 0 ? it->second.lines * 1000.0 / elapsedMs : 0.0;
+            stats["latency"] = it->second.latency.toVariant();
+        } else {
+            stats["error"] = QString::fromStdString(doneEvt.error);
+        }
+        replays.erase(it);
+        lastReplayStats = stats;
+        queueJs("on_replay_done", { QString::fromStdString(doneEvt.connection), stats });
+        break;
+    }
+    case Logger::LogEvent::TypeId: {
+        auto& logEvt = static_cast<Logger::LogEvent&>(evt);
         if(logEvt.lev == Logger::level::error)
-            evalJs("alert2('" + escapeJs(logEvt.msg) + "')");
-        return true;
-    } else if (evt->type() == ProcessRunner::ReadEvent::TypeId) {
-        auto readEvt = dynamic_cast<ProcessRunner::ReadEvent&>(*evt);
-        evalJs("commandStream('" + escapeJs(readEvt.cmd) + "', '" + escapeJs(readEvt.msg) + "')");
-        return true;
-    } else if (evt->type() == ProcessRunner::TerminateEvent::TypeId) {
-        auto termEvt = dynamic_cast<ProcessRunner::TerminateEvent&>(*evt);
-        evalJs("commandStream('exit', '" + escapeJs(termEvt.cmd) + "', " + std::to_string(termEvt.returnCode) + ")");
+            queueJs("alert2", { QString::fromStdString(logEvt.msg) });
+        break;
+    }
+    case ProcessRunner::ReadEvent::TypeId: {
+        auto& readEvt = static_cast<ProcessRunner::ReadEvent&>(evt);
+        QString cmd = QString::fromStdString(readEvt.cmd);
+        for (auto& line : readEvt.lines)
+            queueJs("commandStream", { cmd, QString::fromStdString(line) });
+        break;
+    }
+    case ProcessRunner::TerminateEvent::TypeId: {
+        auto& termEvt = static_cast<ProcessRunner::TerminateEvent&>(evt);
+        queueJs("commandStream", { "exit", QString::fromStdString(termEvt.cmd), termEvt.returnCode,
+            toVariant(termEvt.usage) });
+        if(commandUsageLog)
+            logCommandUsage(termEvt.cmd, termEvt.returnCode, termEvt.usage);
         logger.info("Command finished: ", termEvt.cmd);
         if(processes.count(termEvt.cmd)) {
             processes.find(termEvt.cmd)->second.terminate();
             processes.erase(processes.find(termEvt.cmd));
         }
-        return true;
-    } else if (evt->type() == UnitsyncHandlerAsync::ResultEvent::TypeId) {
-        auto resEvt = dynamic_cast<UnitsyncHandlerAsync::ResultEvent&>(*evt);
-        evalJs("unitsyncResult('" + escapeJs(resEvt.id) + "', '" + escapeJs(resEvt.type) + "', '" + escapeJs(resEvt.res) + "')");
-        return true;
-    } else if (evt->type() == DownloadEvent::TypeId) {
-        auto resEvt = dynamic_cast<DownloadEvent&>(*evt);
-        evalJs("downloadMessage('" + escapeJs(resEvt.name) + "', '" + escapeJs(resEvt.msg) + "')");
-        return true;
-    } else {
-        return QObject::event(evt);
+        break;
+    }
+    case UnitsyncHandlerAsync::ResultEvent::TypeId: {
+        auto& resEvt = static_cast<UnitsyncHandlerAsync::ResultEvent&>(evt);
+        queueJs("unitsyncResult", { QString::fromStdString(resEvt.id), QString::fromStdString(resEvt.type),
+            QString::fromStdString(resEvt.res) });
+        break;
+    }
+    case DownloadEvent::TypeId: {
+        auto& resEvt = static_cast<DownloadEvent&>(evt);
+        if (!resEvt.coalesceKey.empty())
+            resEvt.msg = EventScheduler::takeCoalesced(resEvt.coalesceKey);
+        queueJs("downloadMessage", { QString::fromStdString(resEvt.name), QString::fromStdString(resEvt.msg) });
+        break;
+    }
     }
 }
 
@@ -240,11 +739,26 @@ void LobbyInterface::jsMessage(std::string source, int lineNumber, std::string m
     } else if (message.find("<CMD>") != std::string::npos) {
         if (debugCommands)
             logger.debug(message);
-    } else {
+    } else if (consoleFilter.admit(source, lineNumber, message)) {
         logger.warning(source, ":", lineNumber, " ", message);
     }
 }
 
+void LobbyInterface::flushConsoleFilter() {
+    for (auto& summary : consoleFilter.flush())
+        logger.warning(summary);
+}
+
+QVariantMap LobbyInterface::getConsoleStats() {
+    auto stats = consoleFilter.stats();
+    QVariantMap res;
+    res["received"] = stats.received;
+    res["logged"] = stats.logged;
+    res["folded"] = stats.folded;
+    res["rateLimited"] = stats.rateLimited;
+    return res;
+}
+
 QString LobbyInterface::listDirs(QString path) {
     return listFilesPriv(path, true);
 }
@@ -254,6 +768,7 @@ QString LobbyInterface::listFiles(QString path) {
 }
 
 QString LobbyInterface::listFilesPriv(QString qpath, bool dirs) {
+    Activity activity(dirs ? "listDirs" : "listFiles");
     std::list<std::wstring> files;
     fs::path path = qpath.toStdWString();
 
@@ -283,6 +798,7 @@ QString LobbyInterface::listFilesPriv(QString qpath, bool dirs) {
 }
 
 QString LobbyInterface::readFileLess(QString qpath, unsigned int lines) {
+    Activity activity("readFileLess");
     // TODO: deque? Just read the file in the reverse order, geez.
     fs::path path = qpath.toStdWString();
     uifstream in(path, std::ios::in | std::ios::binary);
@@ -321,8 +837,8 @@ int curl_debug(CURL* /* hnld */, curl_infotype type, char* str, size_t size, voi
 struct ProgressData { std::string name; QObject* eventReceiver; };
 int progress_function(ProgressData data, double dtotal, double dnow, double /*utotal*/, double /*unow*/) {
     if (data.eventReceiver)
-        QCoreApplication::postEvent(data.eventReceiver, new LobbyInterface::DownloadEvent(data.name, "progress:" +
-            std::to_string(dnow) + ":" + std::to_string(dtotal)));
+        EventScheduler::postCoalesced(data.eventReceiver, new LobbyInterface::DownloadEvent(data.name, ""),
+            "download:" + data.name, "progress:" + std::to_string(dnow) + ":" + std::to_string(dtotal));
     return 0;
 }
 size_t static write_data(void* buf, size_t size, size_t mult, void* file) {
@@ -334,6 +850,7 @@ bool LobbyInterface::downloadFile(QString qname, QString qurl, QString qtarget,
     auto name = qname.toStdString();
     fs::path target = qtarget.toStdWString();
     logger.debug("downloadFile(): ", url, " => ", target);
+    TraceSpan span("download", name.empty() ? url : name);
     auto handle = curl_easy_init();
     curl_slist* hlist = NULL;
 
@@ -375,7 +892,7 @@ bool LobbyInterface::downloadFile(QString qname, QString qurl, QString qtarget,
     if ((err = curl_easy_perform(handle)) != 0) {
         logger.error("downloadFile(): can't download file: ", url, " => ", target, ": ", curl_easy_strerror(err));
         if (eventReceiver)
-            QCoreApplication::postEvent(eventReceiver, new DownloadEvent(name, std::string("error:") + curl_easy_strerror(err)));
+            EventScheduler::post(eventReceiver, new DownloadEvent(name, std::string("error:") + curl_easy_strerror(err)), false);
         return false;
     }
     if (hlist)
@@ -395,21 +912,24 @@ bool LobbyInterface::downloadFile(QString qname, QString qurl, QString qtarget,
         logger.warning("downloadFile(): no data received");
     }
     if (eventReceiver)
-        QCoreApplication::postEvent(eventReceiver, new DownloadEvent(name, "done"));
+        EventScheduler::post(eventReceiver, new DownloadEvent(name, "done"), false);
     return true;
 }
 
 bool LobbyInterface::downloadFile(QString qurl, QString qtarget) {
+    Activity activity("downloadFile");
     return downloadFile("", qurl, qtarget, true, NULL);
 }
 
 void LobbyInterface::startDownload(QString name, QString url, QString file, bool checkIfModified) {
     downloadThreads.push_back(boost::thread([=]{
+        Trace::setThreadName("download " + name.toStdString());
         downloadFile(name, url, file, checkIfModified, this);
     }));
 }
 
 QObject* LobbyInterface::getUnitsync(QString qpath) {
+    Activity activity("getUnitsync");
     fs::path path = qpath.toStdWString();
     if (!unitsyncs.count(path)) {
         unitsyncs.insert(std::make_pair(path, UnitsyncHandler(this, logger, path)));
@@ -425,6 +945,7 @@ QObject* LobbyInterface::getUnitsync(QString qpath) {
 }
 
 QObject* LobbyInterface::getUnitsyncAsync(QString qpath) {
+    Activity activity("getUnitsyncAsync");
     fs::path path = qpath.toStdWString();
     if (!unitsyncs_async.count(path)) {
         unitsyncs_async.insert(std::make_pair(path, UnitsyncHandlerAsync(this, logger, path)));
@@ -450,6 +971,7 @@ void LobbyInterface::createScript(QString qpath, QString script) {
 
 void LobbyInterface::killCommand(QString qcmdName)
 {
+    Activity activity("killCommand");
     auto cmdName = qcmdName.toStdString();
     logger.info("Killing command: ", cmdName);
     if(processes.count(cmdName)) {
@@ -459,12 +981,16 @@ void LobbyInterface::killCommand(QString qcmdName)
 }
 
 bool LobbyInterface::runCommand(QString qcmdName, QStringList cmd) {
+    Activity activity("runCommand");
     auto cmdName = qcmdName.toStdString();
     if(!processes.count(cmdName)) {
         std::vector<std::wstring> args;
         for(auto i : cmd)
             args.push_back(i.toStdWString());
-        auto it = processes.insert(std::make_pair(cmdName, ProcessRunner(this, logger, cmdName, args))).first;
+        ProcessRunner::OutputLimits limits = commandOutputLimits;
+        limits.spillDir = springHome / "weblobby" / "logs";
+        auto it = processes.insert(std::make_pair(cmdName, ProcessRunner(this, logger, reaper, cmdName, args,
+            limits))).first;
         logger.info("Running command (", cmdName, "):\n", cmd.join(" ").toStdString());
         try {
             it->second.run();
@@ -478,6 +1004,35 @@ bool LobbyInterface::runCommand(QString qcmdName, QStringList cmd) {
     return false;
 }
 
+void LobbyInterface::setCommandOutputLimits(unsigned int lineRate, unsigned int burst, unsigned int batchInterval) {
+    commandOutputLimits.lineRate = lineRate;
+    commandOutputLimits.burst = burst;
+    commandOutputLimits.batchInterval = batchInterval;
+}
+
+void LobbyInterface::setCommandUsageLog(bool enabled) {
+    commandUsageLog = enabled;
+}
+
+void LobbyInterface::logCommandUsage(const std::string& cmd, int returnCode, const ProcessReaper::Usage& usage) {
+    const fs::path path = springHome / "weblobby" / "logs" / (ProcessRunner::fileName(cmd) + ".usage.csv");
+    boost::system::error_code ec;
+    bool header = !fs::exists(path, ec);
+    uofstream out(path, std::ios::app);
+    if (!out.good()) {
+        logger.warning("Could not write command usage to ", path);
+        return;
+    }
+    if (header) {
+        out << "time,command,return_code,wall_us,user_us,system_us,max_rss_kb,major_faults,read_bytes,write_bytes,"
+            "disk_read_bytes,disk_write_bytes" << std::endl;
+    }
+    out << std::time(NULL) << ',' << ProcessRunner::fileName(cmd) << ',' << returnCode << ',' << usage.wallUs << ','
+        << usage.userUs << ',' << usage.systemUs << ',' << usage.maxRssKb << ',' << usage.majorFaults << ','
+        << usage.readBytes << ',' << usage.writeBytes << ',' << usage.diskReadBytes << ',' << usage.diskWriteBytes
+        << std::endl;
+}
+
 void LobbyInterface::createUiKeys(QString qpath) {
     boost::system::error_code ec;
     fs::path path = qpath.toStdWString();
@@ -517,6 +1072,8 @@ size_t feed_data(void* buf, size_t size, size_t mult, mpg123_handle* mpg) {
 void LobbyInterface::playSound(QString url) {
     #ifdef Q_OS_LINUX
         auto thread = boost::thread([=](){
+            Trace::setThreadName("playSound");
+            TraceSpan span("playSound", url.toStdString());
             mpg123_handle* mpg = mpg123_new(NULL, NULL);
             mpg123_format_none(mpg);
             if (mpg123_format(mpg, 44100, 2, MPG123_ENC_SIGNED_16) == MPG123_ERR) {
@@ -612,55 +1169,229 @@ public String ReadFileMore(final String logFile, final int numLines) {
 }*/
 
 void LobbyInterface::evalJs(const std::string& code) {
-    frame->evaluateJavaScript(QString::fromStdString("__java_js_wrapper(function(){" + code + "}, this);"));
+    frame->evaluateJavaScript(QString::fromStdString(code));
+}
+
+void LobbyInterface::setEventBatching(int maxItems, int maxDelay) {
+    batchMaxItems = std::max(maxItems, 1);
+    batchMaxDelay = std::max(maxDelay, 0);
 }
 
-std::string LobbyInterface::escapeJs(const std::string& str) {
-    std::string res = "";
-    for(char c : str) {
-        if(c == '\'') res += "\\'";
-        else if(c == '\\') res += "\\\\";
-        else if(c == '"') res += "\\\"";
-        else if(c == '\n') res += "\\n";
-        else if(c == '\r') res += "\\r";
-        else res += c;
+void LobbyInterface::setEventQueueLimit(QString eventClass, unsigned int limit) {
+    for (int i = 0; i < eventClassCount; i++) {
+        if (eventClass == EventScheduler::className(EventClass(i))) {
+            EventScheduler::setLimit(EventClass(i), limit);
+            return;
+        }
     }
-    return res;
+    logger.warning("setEventQueueLimit(): unknown event class: ", eventClass.toStdString());
 }
 
-int LobbyInterface::sendSomePacket(QString /* host */, unsigned int /* port */, QString /* msg */) {
-    return -1;
-    /* TODO: This is called from JS but the result is never used. The purpose of
-     * learning the local port of a UDP socket is unclear.
-    try {
-        //int port = 90;
-
-        byte[] message = messageString.getBytes();
-
-        // Get the internet address of the specified host
-        InetAddress address = InetAddress.getByName(host);
-
-        // Initialize a datagram packet with data and address
-        DatagramPacket packet = new DatagramPacket(message, message.length, address, port);
-
-        // Create a datagram socket, send the packet through it, close it.
-        //DatagramSocket dsocket = new DatagramSocket();
-        dsocket.send(packet);
-        System.out.println(""+dsocket.getLocalPort());
-        return dsocket.getLocalPort();
-        //dsocket.close();
-    } catch (Exception e) {
-        System.err.println(e);
-        for(int i=0; i<e.getStackTrace().length; i++)
-        {
-            echoJs( e.getStackTrace()[i]+"" );
+QVariantMap LobbyInterface::getEventQueueStats() {
+    return PerfStats::queueStats();
+}
+
+QVariantMap LobbyInterface::getPerfStats() {
+    return perfStats.toVariant();
+}
+
+// Written to a temporary file first so that a scraper never sees half of it.
+void LobbyInterface::writePerfStats() {
+    const fs::path path = springHome / "weblobby" / "metrics.prom";
+    const fs::path tmp = springHome / "weblobby" / "metrics.prom.tmp";
+    {
+        uofstream out(tmp, std::ios::binary);
+        if (!out.good())
+            return;
+        out << perfStats.toPrometheus();
+    }
+    boost::system::error_code ec;
+    fs::rename(tmp, path, ec);
+}
+
+void LobbyInterface::queueJs(const char* func, std::initializer_list<QVariant> args) {
+    QVariantList call;
+    call.reserve(args.size() + 1);
+    call.append(func);
+    for (auto& arg : args)
+        call.append(arg);
+    jsBatch.append(QVariant(call));
+    if (jsBatch.size() >= batchMaxItems)
+        flushJs();
+    else if (!batchTimer.isActive())
+        batchTimer.start(batchMaxDelay);
+}
+
+// A timeout of 0 fires once the event loop is done with the posted events
+// of this round, so a burst of lines ends up in a single call into JS.
+void LobbyInterface::flushJs() {
+    batchTimer.stop();
+    if (jsBatch.isEmpty())
+        return;
+    Activity activity("evalJs");
+    QVariantList batch;
+    batch.swap(jsBatch);
+    std::vector<ReplayedEvent> replayed;
+    replayed.swap(replayedEvents);
+    std::vector<ProfiledLine> profiled;
+    profiled.swap(profiledLines);
+    if (receivers(SIGNAL(nativeEvents(QVariantList))) > 0) {
+        auto start = PerfStats::clock::now();
+        emit nativeEvents(batch);
+        auto jsTime = PerfStats::clock::now() - start;
+        perfStats.recordJsCall(batch.size(), jsTime);
+        recordReplayed(replayed);
+        recordDispatch(profiled, batch.size(), jsTime);
+        return;
+    }
+
+    // Compatibility path for pages that don't listen to nativeEvents.
+    // An exception thrown by one handler doesn't stop the rest of the batch,
+    // the first one is rethrown afterwards so that __java_js_wrapper still
+    // reports it.
+    jsCode.clear();
+    jsCode += "__java_js_wrapper(function(){var b = [";
+    for (int i = 0; i < batch.size(); i++) {
+        if (i)
+            jsCode += ",";
+        appendJsLiteral(jsCode, batch[i]);
+    }
+    jsCode += "], e = null;"
+        "for (var i = 0; i < b.length; i++) {"
+            "try { window[b[i][0]].apply(window, b[i].slice(1)); } catch(x) { if (e === null) e = x; }"
+        "}"
+        "if (e !== null) throw e;"
+        "}, this);";
+    auto start = PerfStats::clock::now();
+    evalJs(jsCode);
+    auto jsTime = PerfStats::clock::now() - start;
+    perfStats.recordJsCall(batch.size(), jsTime);
+    recordReplayed(replayed);
+    recordDispatch(profiled, batch.size(), jsTime);
+}
+
+// Lines come in runs from the same connection, each run is handed to its
+// profiler at once. The JS call is only timed for the whole batch, so its
+// share is kept apart from the measured conversion time.
+void LobbyInterface::recordDispatch(const std::vector<ProfiledLine>& profiled, int batchSize,
+        PerfStats::clock::duration jsTime) {
+    if (profiled.empty())
+        return;
+    PerfStats::clock::duration share = jsTime / std::max(batchSize, 1);
+    ProtocolProfiler::Timings timings;
+    for (std::size_t i = 0; i < profiled.size(); i++) {
+        timings.push_back(std::make_pair(profiled[i].command, profiled[i].native));
+        if (i + 1 == profiled.size() || profiled[i + 1].profiler != profiled[i].profiler) {
+            profiled[i].profiler->addDispatchTimes(timings, share);
+            timings.clear();
+        }
+    }
+}
+
+void LobbyInterface::recordReplayed(const std::vector<ReplayedEvent>& replayed) {
+    auto now = PerfStats::clock::now();
+    for (auto& evt : replayed) {
+        auto it = replays.find(evt.connection);
+        if (it == replays.end())
+            continue;
+        it->second.lines += evt.lines;
+        for (std::size_t i = 0; i < evt.lines; i++)
+            it->second.latency.add(now - evt.postTime);
+    }
+}
+
+void LobbyInterface::appendJsLiteral(std::string& out, const QVariant& val) {
+    switch (val.type()) {
+    case QVariant::Bool:
+        out += val.toBool() ? "true" : "false";
+        break;
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+        out += val.toString().toStdString();
+        break;
+    case QVariant::Double:
+        escapejs::appendNumber(out, val.toDouble());
+        break;
+    case QVariant::List: {
+        auto list = val.toList();
+        out += "[";
+        for (int i = 0; i < list.size(); i++) {
+            if (i)
+                out += ",";
+            appendJsLiteral(out, list[i]);
         }
+        out += "]";
+        break;
+    }
+    case QVariant::Map: {
+        auto map = val.toMap();
+        out += "{";
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            if (it != map.begin())
+                out += ",";
+            appendJsLiteral(out, it.key());
+            out += ":";
+            appendJsLiteral(out, it.value());
+        }
+        out += "}";
+        break;
+    }
+    default: {
+        QByteArray str = val.toString().toUtf8();
+        out += "'";
+        escapejs::append(out, str.constData(), str.size());
+        out += "'";
+    }
+    }
+}
+
+int LobbyInterface::sendSomePacket(QString host, unsigned int port, QString msg) {
+    namespace ip = boost::asio::ip;
+    boost::system::error_code ec;
+    ip::address address = ip::address::from_string(host.toStdString(), ec);
+    if (ec || port == 0 || port > 65535) {
+        logger.warning("sendSomePacket(): not an IP address and port: ", host.toStdString(), ":", port);
+        return -1;
+    }
+    boost::asio::io_service service;
+    ip::udp::socket socket(service);
+    QByteArray data = msg.toUtf8();
+    socket.open(address.is_v4() ? ip::udp::v4() : ip::udp::v6(), ec);
+    if (!ec)
+        socket.send_to(boost::asio::buffer(data.constData(), data.size()), ip::udp::endpoint(address, port), 0, ec);
+    unsigned int localPort = ec ? 0 : socket.local_endpoint(ec).port();
+    if (ec) {
+        logger.warning("sendSomePacket(): ", ec.message());
+        return -1;
+    }
+    return localPort;
+}
+
+unsigned int LobbyInterface::probeHosts(QVariantList hosts, QVariantMap options) {
+    std::vector<UdpProber::Target> targets;
+    for (auto& host : hosts) {
+        QVariantMap map = host.toMap();
+        UdpProber::Target target = { map["host"].toString().toStdString(), map["port"].toUInt() };
+        targets.push_back(target);
     }
-    return -1;
-    */
+    UdpProber::Options opts;
+    if (options.contains("attempts"))
+        opts.attempts = options["attempts"].toUInt();
+    if (options.contains("timeout"))
+        opts.timeout = options["timeout"].toUInt();
+    if (options.contains("batchInterval"))
+        opts.batchInterval = options["batchInterval"].toUInt();
+    if (options.contains("maxAge"))
+        opts.maxAge = options["maxAge"].toUInt();
+    unsigned int id = nextProbeId++;
+    network.probe(id, std::move(targets), opts);
+    return id;
 }
 
 unsigned int LobbyInterface::getUserID() {
+    Activity activity("getUserID");
     for(auto i : QNetworkInterface::allInterfaces()) {
         if((i.flags() & QNetworkInterface::IsUp) &&
                 (i.flags() & QNetworkInterface::IsRunning) &&
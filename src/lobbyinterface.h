@@ -2,12 +2,29 @@
 #define LOBBYINTERFACE_H
 
 #include "logger.h"
+#include "nativeevent.h"
+#include "perfstats.h"
+#include "watchdog.h"
+#include "consolefilter.h"
+#include "lineframer.h"
+#include "deflatestream.h"
+#include "endpointcache.h"
+#include "lobbyprotocol.h"
+#include "lobbystate.h"
+#include "sessioncapture.h"
+#include "protocolprofiler.h"
+#include "processreaper.h"
+#include "udpprober.h"
 #include "ufstream.h"
+#include "escapejs.h"
 #include "unitsynchandler.h"
 #include "unitsynchandler_t.h"
 #include <QObject>
 #include <QEvent>
 #include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QTimer>
 #ifdef Q_OS_LINUX
     #include <alsa/asoundlib.h>
     #include <mpg123.h>
@@ -15,17 +32,38 @@
     #include <QMediaPlayer>
 #endif
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/thread.hpp>
 #include <boost/process.hpp>
 #include <boost/iostreams/device/file_descriptor.hpp>
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
+#include <random>
 
 class QWebFrame;
 
 class ProcessRunner {
 public:
-    ProcessRunner(QObject* eventReceiver, Logger& logger, const std::string& cmd, const std::vector<std::wstring>& args);
+    struct OutputLimits {
+        OutputLimits() : lineRate(1000), burst(5000), batchInterval(50) {}
+        // At most lineRate lines a second are posted, with bursts of burst,
+        // 0 means no limit. The rest goes to the spill file and is replaced
+        // by "N lines suppressed" markers.
+        unsigned int lineRate, burst;
+        // Lines are gathered for this many ms before they're posted, 0
+        // posts whatever a single read brought.
+        unsigned int batchInterval;
+        // Suppressed lines are written to spillDir/<cmd>.spill.log, or
+        // dropped if it's empty.
+        boost::filesystem::path spillDir;
+    };
+
+    // The process is started, reaped and read from in the reaper's thread.
+    ProcessRunner(QObject* eventReceiver, Logger& logger, ProcessReaper& reaper, const std::string& cmd,
+        const std::vector<std::wstring>& args, const OutputLimits& limits = OutputLimits());
     ProcessRunner(ProcessRunner&&);
     ProcessRunner(const ProcessRunner&) = delete;
     ~ProcessRunner();
@@ -34,63 +72,235 @@ public:
     void run();
     // Throws boost::system::system_error on failure.
     void terminate();
+    // cmd made safe to use in a file name.
+    static std::string fileName(const std::string& cmd);
 
-    // This event is posted to eventReceiver when the underlying process
-    // writes a line into stdout.
-    struct ReadEvent : QEvent {
-        ReadEvent(std::string cmd, std::string msg) : QEvent(QEvent::Type(TypeId)), cmd(cmd), msg(msg) {}
+    // This event is posted to eventReceiver with the lines the underlying
+    // process wrote into stdout and stderr since the last one. Lines end
+    // with "\n", "\r\n" or a lone "\r".
+    struct ReadEvent : NativeEvent {
+        ReadEvent(std::string cmd, std::vector<std::string> lines) : NativeEvent(TypeId, EventClass::process, cmd),
+            cmd(std::move(cmd)), lines(std::move(lines)) {}
         std::string cmd;
-        std::string msg;
+        std::vector<std::string> lines;
         static const int TypeId = QEvent::User + 3; // more magic numbers
     };
     // This event is posted when the process terminates.
-    struct TerminateEvent : QEvent {
-        TerminateEvent(std::string cmd, int retCode) : QEvent(QEvent::Type(TypeId)), cmd(cmd), returnCode(retCode) {}
+    struct TerminateEvent : NativeEvent {
+        TerminateEvent(std::string cmd, int retCode, ProcessReaper::Usage usage) :
+            NativeEvent(TypeId, EventClass::process, cmd), cmd(std::move(cmd)), returnCode(retCode), usage(usage) {}
         std::string cmd;
         int returnCode;
+        ProcessReaper::Usage usage;
         static const int TypeId = QEvent::User + 4; // QEvent::registerEventType() is evil black magic!
     };
 private:
-    void runService();
+    struct State;
     QObject* eventReceiver;
     Logger& logger;
+    ProcessReaper& reaper;
     std::string cmd;
     std::vector<std::wstring> args;
+    OutputLimits limits;
     std::function<void()> terminate_func;
-    int returnCode;
-    boost::asio::io_service service;
-    boost::thread runServiceThread, waitForExitThread;
+    // Shared with the handlers in the reaper thread, null until run().
+    std::shared_ptr<State> state;
 };
 
 class NetworkHandler {
 public:
-    void connect(std::string host, unsigned int port);
-    void disconnect();
-    void send(std::string msg);
+    struct ConnectOptions {
+        ConnectOptions() : compress(false), reconnect(false), tokenize(false), batchLogin(false),
+            mirrorState(false), stateDiffInterval(0) {}
+        // Negotiate a zlib compressed stream right after connecting: the
+        // client sends "COMPRESS deflate" and the server either answers
+        // "COMPRESSOK deflate", after which both directions are compressed,
+        // or with anything else, in which case the connection stays plain.
+        // The server's "TASServer" greeting may come before the answer.
+        bool compress;
+        // Connect again with jittered exponential backoff whenever the
+        // connection fails or is lost, until disconnect() is called.
+        bool reconnect;
+        // Deliver lines split into commands and arguments, see LobbyTokenizer.
+        bool tokenize;
+        // Implies tokenize. The login burst arrives as a single LoginBatch.
+        bool batchLogin;
+        // Keep a LobbyState of the connection, see lobbyState().
+        bool mirrorState;
+        // With mirrorState, post a StateDiffEvent at most every this many
+        // ms while the state changes. 0 means no diffs.
+        unsigned int stateDiffInterval;
+    };
+    // Any number of connections share the network thread, each under its own
+    // name, "" being the main lobby connection. Connecting a name that is
+    // already connected drops the old connection.
+    // All resolved addresses are raced, a new attempt starting every 250 ms
+    // or as soon as the previous one fails, and the first to connect wins.
+    // Cached addresses are tried while DNS is still resolving.
+    void connect(const std::string& name, std::string host, unsigned int port, ConnectOptions options = ConnectOptions());
+    void disconnect(const std::string& name);
+    void disconnectAll();
+    // Queues msg, messages go out in the order they were sent.
+    void send(const std::string& name, std::string msg);
+    // Names of the connections between connect() and disconnect().
+    std::vector<std::string> connectionNames() const;
+
+    // Records every line name receives and sends to path, see CaptureWriter.
+    // Capturing can start before connect() to include the login.
+    void startCapture(const std::string& name, const boost::filesystem::path& path);
+    void stopCapture(const std::string& name);
+    // Drops the connection name and feeds it the lines received in a capture
+    // instead, through the same ReadEvents, tokenizing and state mirroring
+    // as options ask for. speed 1 is real time, 0 as fast as possible.
+    // A ReplayDoneEvent follows the last line.
+    void replay(const std::string& name, const boost::filesystem::path& path, ConnectOptions options, double speed);
+
+    // Outgoing traffic of every connection is paced with a token bucket of
+    // burst bytes refilled at rate bytes per second, so that bursts from JS
+    // don't trip the server's flood protection. Part of the bucket is kept
+    // for chat, which still never overtakes earlier messages. A rate of 0,
+    // the default, disables pacing.
+    void setPacing(unsigned int rate, unsigned int burst);
+    // While connected, "#id PING" is sent every interval ms and the matching
+    // PONGs are consumed here, they never reach eventReceiver. If a ping
+    // goes unanswered for stallWindow ms and nothing else arrived in that
+    // time either, the link is considered dead and closed like a failed
+    // connection. An interval of 0, the default, disables the monitor.
+    void setLinkMonitor(unsigned int interval, unsigned int stallWindow);
+    // Where resolved addresses are remembered across runs.
+    void setCachePath(const boost::filesystem::path&);
+    // Measures UDP round trip times to game hosts from the network thread,
+    // see UdpProber. The results arrive in batches as ProbeEvents.
+    void probe(unsigned int id, std::vector<UdpProber::Target> targets, UdpProber::Options options);
+
+    // The mirrored state of a connection, null unless it was connected with
+    // mirrorState. It's updated from the network thread, its queries can be
+    // called from any thread.
+    std::shared_ptr<const LobbyState> lobbyState(const std::string& name) const;
+    // Every connection profiles its traffic by command, counting stays with
+    // the connection across reconnects. Null for unknown connections.
+    std::shared_ptr<const ProtocolProfiler> protocolProfiler(const std::string& name) const;
+
+    // The stats getters below return zeroes for unknown connections.
+    struct SendStats {
+        unsigned long long queuedMessages, queuedBytes, inFlightBytes;
+        unsigned long long sentMessages, sentBytes, pacedWaits;
+    };
+    SendStats sendStats(const std::string& name) const;
+
+    // Bytes as seen by the protocol and as they went over the wire.
+    struct TransportStats {
+        bool compressed;
+        unsigned long long bytesIn, wireBytesIn, bytesOut, wireBytesOut;
+    };
+    TransportStats transportStats(const std::string& name) const;
+
+    // Time to connect is measured from connect() or the start of a
+    // reconnect, DNS included, to the winning attempt.
+    struct ConnectStats {
+        unsigned long long connects, failures, reconnects;
+        long long lastConnectUs, lastResolveUs;
+        unsigned int lastEndpointsTried;
+        bool lastFromCache;
+        std::string lastEndpoint;
+    };
+    ConnectStats connectStats(const std::string& name) const;
+
+    // RTTs in microseconds over the last rttWindow answered pings, jitter
+    // is the RFC 3550 smoothed difference between consecutive RTTs.
+    struct LinkStats {
+        long long lastRttUs, minRttUs, meanRttUs, p50RttUs, p99RttUs, maxRttUs, jitterUs;
+        unsigned int samples;
+        unsigned long long pingsSent, pongsReceived, pingsLost, stalls;
+    };
+    LinkStats linkStats(const std::string& name) const;
+    static const std::size_t rttWindow = 256;
 
     NetworkHandler(QObject* eventReceiver, Logger& logger);
     ~NetworkHandler();
 
     // This event is posted to eventReceiver when some data arrives in the socket.
-    struct ReadEvent : QEvent {
-        ReadEvent(std::string msg) : QEvent(QEvent::Type(TypeId)), msg(msg) {}
-        std::string msg;
+    // It carries every complete line that arrived with a single read, either
+    // as is or tokenized into commands, or a finished login batch.
+    struct ReadEvent : NativeEvent {
+        ReadEvent(std::string connection, std::vector<std::string> lines) :
+            NativeEvent(TypeId, EventClass::protocol, connection), connection(std::move(connection)),
+            lines(std::move(lines)) {}
+        ReadEvent(std::string connection, std::vector<LobbyCommand> commands) :
+            NativeEvent(TypeId, EventClass::protocol, connection), connection(std::move(connection)),
+            commands(std::move(commands)) {}
+        ReadEvent(std::string connection, std::unique_ptr<LoginBatch> batch) :
+            NativeEvent(TypeId, EventClass::protocol, connection), connection(std::move(connection)),
+            batch(std::move(batch)) {}
+        std::string connection;
+        std::vector<std::string> lines;
+        std::vector<LobbyCommand> commands;
+        std::unique_ptr<LoginBatch> batch;
+        // Where the receiver adds the time it spent on each line.
+        std::shared_ptr<ProtocolProfiler> profiler;
         static const int TypeId = QEvent::User + 1; // watch ma, no hands! magic! (hides saw)
     };
     // This event represents a socket error. The socket is always closed before this event is posted.
-    struct ErrorEvent : QEvent {
-        ErrorEvent(std::string reason) : QEvent(QEvent::Type(TypeId)), reason(reason) {}
+    struct ErrorEvent : NativeEvent {
+        ErrorEvent(std::string connection, std::string reason) : NativeEvent(TypeId, EventClass::protocol, connection),
+            connection(std::move(connection)), reason(std::move(reason)) {}
+        std::string connection;
         std::string reason;
         static const int TypeId = QEvent::User + 7; // lucky magic number
     };
+    struct ReplayStats {
+        ReplayStats() : lines(0), bytes(0), feedUs(0) {}
+        unsigned long long lines, bytes;
+        // From the start of the replay to the last line handed over.
+        long long feedUs;
+    };
+    struct ReplayDoneEvent : NativeEvent {
+        ReplayDoneEvent(std::string connection, ReplayStats stats, std::string error) :
+            NativeEvent(TypeId, EventClass::protocol, connection), connection(std::move(connection)), stats(stats),
+            error(std::move(error)) {}
+        std::string connection;
+        ReplayStats stats;
+        // Set if the capture couldn't be read.
+        std::string error;
+        static const int TypeId = QEvent::User + 9; // magic on repeat
+    };
+    // What changed in a mirrored LobbyState since the last one, see
+    // ConnectOptions::stateDiffInterval.
+    struct StateDiffEvent : NativeEvent {
+        StateDiffEvent(std::string connection, LobbyState::Diff diff) :
+            NativeEvent(TypeId, EventClass::protocol, connection), connection(std::move(connection)),
+            diff(std::move(diff)) {}
+        std::string connection;
+        LobbyState::Diff diff;
+        static const int TypeId = QEvent::User + 8; // magic, but the coalesced kind
+    };
+    struct ProbeEvent : NativeEvent {
+        ProbeEvent(unsigned int id, std::vector<UdpProber::Result> results, bool done) :
+            NativeEvent(TypeId, EventClass::progress), id(id), results(std::move(results)), done(done) {}
+        unsigned int id;
+        std::vector<UdpProber::Result> results;
+        // Set on the last batch of a probe.
+        bool done;
+        static const int TypeId = QEvent::User + 10; // ping of magic
+    };
 private:
+    class Connection;
+    std::shared_ptr<Connection> find(const std::string& name) const;
+    std::shared_ptr<Connection> obtain(const std::string& name);
+    void retire(std::shared_ptr<Connection>);
     void runService();
-    void onRead(const boost::system::error_code&, std::size_t);
     boost::asio::io_service service;
     boost::asio::io_service::work* work;
-    boost::asio::ip::udp::resolver resolver;
-    boost::asio::ip::tcp::socket socket;
-    boost::asio::streambuf readBuf;
+    // Connections are added and removed in the network thread, the mutex is
+    // for lookups from other threads. Getters hold on to what they found.
+    mutable boost::mutex connectionsMutex;
+    std::map<std::string, std::shared_ptr<Connection>> connections;
+    // The rest is only touched in the network thread.
+    // Disconnected connections whose handlers are still pending.
+    std::map<Connection*, std::shared_ptr<Connection>> retired;
+    EndpointCache endpointCache;
+    unsigned int pacingRate, pacingBurst, pingInterval, stallWindow;
+    UdpProber prober;
     boost::thread thread;
     QObject* eventReceiver;
     Logger& logger;
@@ -104,12 +314,21 @@ public:
     bool event(QEvent* evt);
 
     // This is posted for asynchronous HTTP downloads.
-    struct DownloadEvent : QEvent {
-        DownloadEvent(std::string name, std::string msg) : QEvent(QEvent::Type(TypeId)), name(name), msg(msg) {}
+    // Progress messages are coalesced, see EventScheduler::postCoalesced().
+    struct DownloadEvent : NativeEvent {
+        DownloadEvent(std::string name, std::string msg) : NativeEvent(TypeId, EventClass::progress, name),
+            name(std::move(name)), msg(std::move(msg)) {}
         std::string name, msg;
         static const int TypeId = QEvent::User + 6; // grep for 'magic' to check for conflicts
     };
 signals:
+    // Typed push channel for native events. Each item of the batch is a list
+    // [func, args...] where func is the name of the global JS callback the
+    // event used to be delivered to (on_socket_get, commandStream, ...).
+    // Connect with QWeblobbyApplet.nativeEvents.connect(function(batch){...}),
+    // as long as nothing is connected the callbacks are invoked through
+    // evaluateJavaScript() instead.
+    void nativeEvents(QVariantList batch);
 public slots:
     //add public functions here
 
@@ -127,16 +346,129 @@ public slots:
     QObject* getUnitsync(QString path);
     QObject* getUnitsyncAsync(QString path);
 
+    // Native events are handed to JS in batches of at most maxItems calls,
+    // flushed no later than maxDelay ms after the first one was queued.
+    void setEventBatching(int maxItems, int maxDelay);
+    // Limits how many events of a class ("protocol", "unitsync", "process",
+    // "progress" or "log") each source (a connection, a command, a
+    // download) may have waiting for the GUI thread, 0 means unlimited.
+    // Lobby protocol lines, connection errors and process output are never
+    // dropped, they only count towards the limit.
+    void setEventQueueLimit(QString eventClass, unsigned int limit);
+    // Per class posted/dropped/coalesced counters and current queue depth.
+    QVariantMap getEventQueueStats();
+    // Event counts, queue wait and dispatch time histograms of the native
+    // event path, also written periodically to springHome/weblobby/metrics.prom
+    // in Prometheus text format.
+    QVariantMap getPerfStats();
+    // JS console messages received, logged, folded into "repeated N times"
+    // summaries and dropped by the rate limit.
+    QVariantMap getConsoleStats();
+    // Paces what send() and sendNamed() write, see NetworkHandler::setPacing().
+    void setSendPacing(unsigned int rate, unsigned int burst);
+    // Messages and bytes waiting in the send queue or being written, totals
+    // sent and how often pacing held traffic back.
+    QVariantMap getSendQueueStats();
+    // Whether the connection is compressed and how many bytes it carried
+    // before and after compression in each direction.
+    QVariantMap getTransportStats();
+    // Connects, failures and reconnects so far and how the last connection
+    // was made: time to connect and to resolve in ms, endpoints tried, if
+    // a cached address was used and which endpoint won.
+    QVariantMap getConnectStats();
+    // See NetworkHandler::setLinkMonitor(), both in ms.
+    void setLinkMonitor(unsigned int interval, unsigned int stallWindow);
+    // Round trip time to the lobby server measured by the native ping:
+    // last, min, mean, p50, p99 and max RTT and jitter in ms, plus ping,
+    // pong, lost ping and stall counts.
+    QVariantMap getLinkStats();
+
     void killCommand(QString cmdName);
     bool runCommand(QString cmdName, QStringList args);
+    // Applies to commands started afterwards: at most lineRate lines a
+    // second (bursts of burst, 0 is unlimited) reach commandStream(), in
+    // batches gathered for batchInterval ms. The rest is written to
+    // springHome/weblobby/logs/<cmdName>.spill.log and announced with a
+    // "N lines suppressed" line.
+    void setCommandOutputLimits(unsigned int lineRate, unsigned int burst, unsigned int batchInterval);
+    // The exit of a command is reported as commandStream("exit", cmdName,
+    // returnCode, usage), usage holding wallMs, userMs, systemMs, maxRssKb,
+    // majorFaults, readBytes, writeBytes, diskReadBytes and diskWriteBytes,
+    // -1 where unknown. With enabled each exit is also appended to
+    // springHome/weblobby/logs/<cmdName>.usage.csv.
+    void setCommandUsageLog(bool enabled);
 
     void connect(QString host, unsigned int port);
+    // options: compress (bool) negotiates a compressed connection,
+    // reconnect (bool) reconnects automatically after failures,
+    // tokenize (bool) delivers lines split up through
+    // on_socket_command(command, args, id) instead of on_socket_get(line),
+    // batchLogin (bool) additionally gathers everything between ACCEPTED and
+    // LOGININFOEND into one on_socket_login_batch(batch) call, see LoginBatch.
+    // mirrorState (bool) keeps a native copy of users, battles and channels
+    // for queryLobbyState(), with stateDiffInterval (ms) what changed is
+    // delivered through on_state_diff(diff) at most that often.
+    // Named connections use the on_named_* variants, name first.
+    void connect(QString host, unsigned int port, QVariantMap options);
     void disconnect();
     void send(QString msg);
+    // Secondary lobby connections (relays, bot accounts, other servers) next
+    // to the main one, same options as connect(). Lines and errors arrive
+    // through on_named_socket_get(name, line) and
+    // on_named_socket_error(name, reason).
+    void connectNamed(QString name, QString host, unsigned int port, QVariantMap options);
+    void disconnectNamed(QString name);
+    void sendNamed(QString name, QString msg);
+    // Names of the secondary connections between connectNamed() and disconnectNamed().
+    QStringList getConnections();
+    // The send, transport, connect and link stats of a connection, "" is
+    // the main one.
+    QVariantMap getConnectionStats(QString name);
+    // Rows of table ("users", "battles" or "channels") of a connection with
+    // mirrorState, as { total, rows }. query: connection (default the main
+    // one), where ({ field: value }), search (substring of names, titles,
+    // maps and games), sortBy, descending, offset, limit.
+    QVariantMap queryLobbyState(QString table, QVariantMap query);
+    // Records every line a connection ("" for the main one) receives and
+    // sends into springHome/weblobby/logs, returns the file name.
+    QString startCapture(QString name);
+    void stopCapture(QString name);
+    // Replays a capture (a path, relative ones are in the logs folder) as if
+    // connection name received it. options are those of connect() plus
+    // speed: 1 (the default) replays in real time, 0 as fast as possible.
+    // Once everything was handed to JS, on_replay_done(name, stats) reports
+    // lines, bytes, elapsedMs, linesPerSec and the latency of a line from
+    // the network thread through its JS callback, or error.
+    void replayCapture(QString name, QString path, QVariantMap options);
+    // The stats of the last finished replay.
+    QVariantMap getReplayStats();
+    // Traffic of a connection by command word since it was connected:
+    // commands maps each command to inMessages, inBytes, outMessages,
+    // outBytes, parsed and parseMs (tokenizing and state mirroring, only
+    // with tokenize or mirrorState), dispatched, convertMs (turning lines
+    // into JS calls, measured per line) and jsShareMs (the JS call of each
+    // batch split evenly over its lines, JS is only timed per batch so this
+    // isn't the cost of the command itself). top lists the topN commands
+    // with the most bytes in the last minute as { command, windows },
+    // windows holding messagesPerSec and bytesPerSec over the last "1",
+    // "10" and "60" seconds.
+    // The top ten by bytes are also logged whenever the connection closes.
+    QVariantMap getProtocolProfile(QString name, int topN);
     bool downloadFile(QString url, QString target);
     void startDownload(QString name, QString url, QString file, bool checkIfModified);
     unsigned int getUserID();
+    // Sends msg in one datagram from a fresh UDP socket, returns the local
+    // port it went out from or -1.
     int sendSomePacket(QString host, unsigned int port, QString msg);
+    // Measures the UDP round trip time to each of hosts ({ host, port },
+    // numeric IPv4 addresses) and returns an id. Results arrive in batches
+    // through on_probe_results(id, results, done), each result holding
+    // host, port, status ("reply", "icmp", "timeout" or "error"), rttMs,
+    // cached and error. A host that answers with ICMP port unreachable is
+    // as good as one echoing the probe, that is what game hosts do between
+    // games. options: attempts (2), timeout (ms between attempts, 1000),
+    // batchInterval (ms, 50) and maxAge (ms a result is cached, 60000).
+    unsigned int probeHosts(QVariantList hosts, QVariantMap options);
 
     void playSound(QString url);
 
@@ -145,11 +477,23 @@ public slots:
     void writeSpringHomeSetting(QString path);
     // The version number is major * 100 + minor.
     // major is incremented with every breaking change in the API.
-    int getApiVersion() { return 105; }
+    int getApiVersion() { return 106; }
 private:
     QString listFilesPriv(QString path, bool dirs);
+    void handleNativeEvent(NativeEvent&);
+    void flushConsoleFilter();
+    void writePerfStats();
+    // Appends a line to the usage CSV of cmd, with a header if it's new.
+    void logCommandUsage(const std::string& cmd, int returnCode, const ProcessReaper::Usage&);
     void evalJs(const std::string&);
-    std::string escapeJs(const std::string&);
+    void appendJsLiteral(std::string& out, const QVariant&);
+    // Queues a call of the global JS function func.
+    void queueJs(const char* func, std::initializer_list<QVariant> args);
+    void flushJs();
+    struct ReplayedEvent;
+    void recordReplayed(const std::vector<ReplayedEvent>&);
+    struct ProfiledLine;
+    void recordDispatch(const std::vector<ProfiledLine>&, int batchSize, PerfStats::clock::duration jsTime);
     void move(const boost::filesystem::path& from, const boost::filesystem::path& to);
     bool downloadFile(QString name, QString qurl, QString qtarget, bool checkIfModified, QObject* eventReceiver);
 
@@ -165,12 +509,54 @@ private:
     #endif
 
     QWebFrame* frame;
+    // [func, args...] lists waiting to be flushed by flushJs().
+    QVariantList jsBatch;
+    // Reused by flushJs() so that building the code doesn't reallocate.
+    std::string jsCode;
+    int batchMaxItems, batchMaxDelay;
+    QTimer batchTimer;
+    PerfStats perfStats;
+    QTimer perfStatsTimer;
+    std::unique_ptr<StallWatchdog> watchdog;
+    QTimer heartbeatTimer;
+    ConsoleFilter consoleFilter;
+    QTimer consoleFilterTimer;
     std::map<boost::filesystem::path, UnitsyncHandler> unitsyncs;
     std::map<boost::filesystem::path, UnitsyncHandlerAsync> unitsyncs_async;
+    // Outlives the processes, they close their pipes through it.
+    ProcessReaper reaper;
+    ProcessRunner::OutputLimits commandOutputLimits;
+    bool commandUsageLog;
     std::map<std::string, ProcessRunner> processes;
     // This doesn't ever get cleared for simplicity on the presumption that
     // there are never enough downloads for that to matter.
     std::vector<boost::thread> downloadThreads;
+    // Replays in progress by connection name.
+    struct ReplayRun {
+        ReplayRun() : lines(0) {}
+        PerfStats::clock::time_point start;
+        unsigned long long lines;
+        PerfStats::Histogram latency;
+    };
+    std::map<std::string, ReplayRun> replays;
+    // Replayed events in jsBatch: connection, post time and number of lines.
+    // Their latency is taken once JS is done with them.
+    struct ReplayedEvent {
+        std::string connection;
+        PerfStats::clock::time_point postTime;
+        std::size_t lines;
+    };
+    std::vector<ReplayedEvent> replayedEvents;
+    QVariantMap lastReplayStats;
+    // Lines in jsBatch and the time it took to convert them, the JS call is
+    // shared out once the batch is flushed.
+    struct ProfiledLine {
+        std::shared_ptr<ProtocolProfiler> profiler;
+        std::string command;
+        PerfStats::clock::duration native;
+    };
+    std::vector<ProfiledLine> profiledLines;
+    unsigned int nextProbeId;
 };
 
 // utf-8 string to utf-16 (on windows).
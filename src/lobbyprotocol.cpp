@@ -0,0 +1,110 @@
+#include "lobbyprotocol.h"
+#include <cstring>
+#include <unordered_map>
+
+// Number of space separated words before the sentences, per command of the
+// Spring lobby protocol. Commands that are all words aren't listed.
+static int wordCount(const std::string& command) {
+    static const std::unordered_map<std::string, int> schema = {
+        { "ADDBOT", 5 },
+        { "ADDUSER", 4 },
+        { "AGREEMENT", 0 },
+        { "BATTLEOPENED", 11 },
+        { "BROADCAST", 0 },
+        { "CHANNEL", 2 },
+        { "CHANNELMESSAGE", 1 },
+        { "CHANNELTOPIC", 3 },
+        { "DENIED", 0 },
+        { "FORCELEAVECHANNEL", 2 },
+        { "JOINBATTLEFAILED", 0 },
+        { "JOINFAILED", 1 },
+        { "LEFT", 2 },
+        { "MOTD", 0 },
+        { "OPENBATTLEFAILED", 0 },
+        { "REGISTRATIONDENIED", 0 },
+        { "SAID", 2 },
+        { "SAIDBATTLE", 1 },
+        { "SAIDBATTLEEX", 1 },
+        { "SAIDEX", 2 },
+        { "SAIDPRIVATE", 1 },
+        { "SAIDPRIVATEEX", 1 },
+        { "SAYPRIVATE", 1 },
+        { "SERVERMSG", 0 },
+        { "SERVERMSGBOX", 0 },
+        { "SETSCRIPTTAGS", 0 },
+        { "UPDATEBATTLEINFO", 4 },
+    };
+    auto it = schema.find(command);
+    return it == schema.end() ? -1 : it->second;
+}
+
+static const char* findChar(const char* p, const char* end, char c) {
+    const char* at = static_cast<const char*>(std::memchr(p, c, end - p));
+    return at ? at : end;
+}
+
+void LobbyTokenizer::tokenize(const std::string& line, LobbyCommand& cmd) {
+    const char* p = line.data();
+    const char* end = p + line.size();
+    if (p != end && end[-1] == '\r')
+        end--;
+    if (p != end && *p == '#') {
+        const char* sp = findChar(p, end, ' ');
+        cmd.id.assign(p + 1, sp);
+        p = sp == end ? end : sp + 1;
+    }
+    const char* sp = findChar(p, end, ' ');
+    cmd.command.assign(p, sp);
+    if (sp == end)
+        return;
+    p = sp + 1;
+    int words = wordCount(cmd.command);
+    for (int i = 0; words < 0 || i < words; i++) {
+        sp = findChar(p, end, ' ');
+        cmd.args.emplace_back(p, sp);
+        if (sp == end)
+            return;
+        p = sp + 1;
+    }
+    for (;;) {
+        const char* tab = findChar(p, end, '\t');
+        cmd.args.emplace_back(p, tab);
+        if (tab == end)
+            return;
+        p = tab + 1;
+    }
+}
+
+bool LobbyTokenizer::feed(LobbyCommand& cmd) {
+    if (!batchLogin)
+        return true;
+    if (batch) {
+        if (cmd.command != "LOGININFOEND") {
+            batch->add(std::move(cmd));
+            return false;
+        }
+        done = std::move(batch);
+    } else if (cmd.command == "ACCEPTED") {
+        batch.reset(new LoginBatch);
+    }
+    return true;
+}
+
+void LobbyTokenizer::reset() {
+    batch.reset();
+    done.reset();
+}
+
+void LoginBatch::add(LobbyCommand&& cmd) {
+    Table& table = tables[cmd.command];
+    std::size_t row = table.seq.size();
+    if (cmd.args.size() > table.columns.size())
+        table.columns.resize(cmd.args.size(), std::vector<std::string>(row));
+    for (std::size_t i = 0; i < table.columns.size(); i++) {
+        if (i < cmd.args.size())
+            table.columns[i].push_back(std::move(cmd.args[i]));
+        else
+            table.columns[i].emplace_back();
+    }
+    table.seq.push_back(lines++);
+}
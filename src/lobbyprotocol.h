@@ -0,0 +1,60 @@
+#ifndef LOBBYPROTOCOL_H
+#define LOBBYPROTOCOL_H
+
+// Splits lobby protocol lines into a command and its arguments. Each command
+// has a fixed number of space separated words followed by tab separated
+// sentences, which may contain spaces, e.g.
+//   SAID channel user {message}
+// Commands not in the schema are split at every space. Splitting is lossless,
+// joining the words with ' ' and the sentences with '\t' gives the line back.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct LobbyCommand {
+    // The "#id" of the line without the '#', empty if it has none.
+    std::string id;
+    std::string command;
+    std::vector<std::string> args;
+};
+
+// Every line between ACCEPTED and LOGININFOEND, grouped by command and stored
+// column by column: row i of each column belongs to the same line, seq[i] is
+// that line's position in the burst. Rows with fewer arguments than the
+// widest one of their command are padded with empty strings.
+struct LoginBatch {
+    LoginBatch() : lines(0) {}
+    void add(LobbyCommand&& cmd);
+
+    struct Table {
+        std::vector<unsigned int> seq;
+        std::vector<std::vector<std::string>> columns;
+    };
+    std::map<std::string, Table> tables;
+    unsigned int lines;
+};
+
+class LobbyTokenizer {
+public:
+    // With batchLogin the login burst is gathered into a LoginBatch instead
+    // of being returned line by line.
+    explicit LobbyTokenizer(bool batchLogin = false) : batchLogin(batchLogin) {}
+
+    static void tokenize(const std::string& line, LobbyCommand& cmd);
+
+    // Takes a tokenized cmd. Returns false if it went into the login batch,
+    // true if it should be delivered. ACCEPTED and LOGININFOEND are always
+    // delivered, the batch is ready to be taken just before LOGININFOEND is.
+    bool feed(LobbyCommand& cmd);
+    // The finished login batch, null if there is none.
+    std::unique_ptr<LoginBatch> takeBatch() { return std::move(done); }
+    // Drops a half gathered burst, e.g. after a reconnect.
+    void reset();
+private:
+    bool batchLogin;
+    std::unique_ptr<LoginBatch> batch, done;
+};
+
+#endif // LOBBYPROTOCOL_H
@@ -0,0 +1,407 @@
+#include "lobbystate.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+typedef LobbyState::Value Value;
+
+template<> const std::vector<LobbyState::Field<LobbyState::User>>& LobbyState::fields<LobbyState::User>() {
+    // Status bits: in game, away, 3 bits of rank, moderator, bot.
+    static const std::vector<Field<User>> res = {
+        { "name", [](const User& u) { return Value(u.name); } },
+        { "country", [](const User& u) { return Value(u.country); } },
+        { "cpu", [](const User& u) { return Value(u.cpu); } },
+        { "accountId", [](const User& u) { return Value(u.accountId); } },
+        { "lobbyId", [](const User& u) { return Value(u.lobbyId); } },
+        { "status", [](const User& u) { return Value(u.status); } },
+        { "inGame", [](const User& u) { return Value(u.status & 1); } },
+        { "away", [](const User& u) { return Value(u.status >> 1 & 1); } },
+        { "rank", [](const User& u) { return Value(u.status >> 2 & 7); } },
+        { "moderator", [](const User& u) { return Value(u.status >> 5 & 1); } },
+        { "bot", [](const User& u) { return Value(u.status >> 6 & 1); } },
+        { "battle", [](const User& u) { return Value(u.battle); } },
+    };
+    return res;
+}
+
+template<> const std::vector<LobbyState::Field<LobbyState::Battle>>& LobbyState::fields<LobbyState::Battle>() {
+    static const std::vector<Field<Battle>> res = {
+        { "id", [](const Battle& b) { return Value(b.id); } },
+        { "type", [](const Battle& b) { return Value(b.type); } },
+        { "natType", [](const Battle& b) { return Value(b.natType); } },
+        { "founder", [](const Battle& b) { return Value(b.founder); } },
+        { "ip", [](const Battle& b) { return Value(b.ip); } },
+        { "port", [](const Battle& b) { return Value(b.port); } },
+        { "maxPlayers", [](const Battle& b) { return Value(b.maxPlayers); } },
+        { "passworded", [](const Battle& b) { return Value(b.passworded); } },
+        { "rank", [](const Battle& b) { return Value(b.rank); } },
+        { "mapHash", [](const Battle& b) { return Value(b.mapHash); } },
+        { "engineName", [](const Battle& b) { return Value(b.engineName); } },
+        { "engineVersion", [](const Battle& b) { return Value(b.engineVersion); } },
+        { "map", [](const Battle& b) { return Value(b.map); } },
+        { "title", [](const Battle& b) { return Value(b.title); } },
+        { "game", [](const Battle& b) { return Value(b.game); } },
+        { "spectators", [](const Battle& b) { return Value(b.spectators); } },
+        { "locked", [](const Battle& b) { return Value(b.locked); } },
+        { "players", [](const Battle& b) { return Value((long long)b.members.size() - b.spectators); } },
+    };
+    return res;
+}
+
+template<> const std::vector<LobbyState::Field<LobbyState::Channel>>& LobbyState::fields<LobbyState::Channel>() {
+    static const std::vector<Field<Channel>> res = {
+        { "name", [](const Channel& c) { return Value(c.name); } },
+        { "topic", [](const Channel& c) { return Value(c.topic); } },
+        { "topicAuthor", [](const Channel& c) { return Value(c.topicAuthor); } },
+        { "userCount", [](const Channel& c) { return Value((long long)c.users.size()); } },
+    };
+    return res;
+}
+
+template<class Key, class Row> Row* LobbyState::Table<Key, Row>::find(const Key& key) {
+    auto it = index.find(key);
+    return it == index.end() ? NULL : &rows[it->second];
+}
+
+template<class Key, class Row> const Row* LobbyState::Table<Key, Row>::find(const Key& key) const {
+    auto it = index.find(key);
+    return it == index.end() ? NULL : &rows[it->second];
+}
+
+template<class Key, class Row> Row& LobbyState::Table<Key, Row>::insert(const Key& key) {
+    auto res = index.insert(std::make_pair(key, rows.size()));
+    if (res.second) {
+        rows.emplace_back();
+        keys.push_back(key);
+    }
+    return rows[res.first->second];
+}
+
+template<class Key, class Row> bool LobbyState::Table<Key, Row>::erase(const Key& key) {
+    auto it = index.find(key);
+    if (it == index.end())
+        return false;
+    std::size_t pos = it->second;
+    index.erase(it);
+    if (pos + 1 != rows.size()) {
+        rows[pos] = std::move(rows.back());
+        keys[pos] = std::move(keys.back());
+        index[keys[pos]] = pos;
+    }
+    rows.pop_back();
+    keys.pop_back();
+    return true;
+}
+
+static long long num(const std::vector<std::string>& args, std::size_t i) {
+    return i < args.size() ? std::strtoll(args[i].c_str(), NULL, 10) : 0;
+}
+
+static const std::string& str(const std::vector<std::string>& args, std::size_t i) {
+    static const std::string empty;
+    return i < args.size() ? args[i] : empty;
+}
+
+void LobbyState::apply(const LobbyCommand& cmd) {
+    const std::string& c = cmd.command;
+    const std::vector<std::string>& a = cmd.args;
+    std::lock_guard<std::mutex> lock(mutex);
+    applied++;
+    if (c == "CLIENTSTATUS") {
+        if (User* user = userTable.find(str(a, 0))) {
+            user->status = num(a, 1);
+            touchUser(user->name);
+        }
+    } else if (c == "ADDUSER") {
+        // A user added twice starts over, without the battle and channels
+        // of the old entry.
+        removeUser(str(a, 0));
+        User& user = userTable.insert(str(a, 0));
+        user.name = str(a, 0);
+        user.country = str(a, 1);
+        user.cpu = num(a, 2);
+        user.accountId = num(a, 3);
+        user.lobbyId = str(a, 4);
+        user.status = 0;
+        user.battle = -1;
+        touchUser(user.name);
+    } else if (c == "REMOVEUSER") {
+        removeUser(str(a, 0));
+    } else if (c == "BATTLEOPENED") {
+        long long id = num(a, 0);
+        // Likewise a reopened battle id, its old members are let go.
+        closeBattle(id);
+        Battle& battle = battleTable.insert(id);
+        battle.id = id;
+        battle.type = num(a, 1);
+        battle.natType = num(a, 2);
+        battle.founder = str(a, 3);
+        battle.ip = str(a, 4);
+        battle.port = num(a, 5);
+        battle.maxPlayers = num(a, 6);
+        battle.passworded = num(a, 7);
+        battle.rank = num(a, 8);
+        battle.mapHash = str(a, 9);
+        battle.engineName = str(a, 10);
+        battle.engineVersion = str(a, 11);
+        battle.map = str(a, 12);
+        battle.title = str(a, 13);
+        battle.game = str(a, 14);
+        battle.spectators = 0;
+        battle.locked = 0;
+        battle.members.clear();
+        touchBattle(id);
+        // The founder is in the battle without a JOINEDBATTLE.
+        if (User* founder = userTable.find(battle.founder)) {
+            leaveBattle(founder->name);
+            founder->battle = id;
+            battleTable.find(id)->members.push_back(founder->name);
+            touchUser(founder->name);
+        }
+    } else if (c == "UPDATEBATTLEINFO") {
+        if (Battle* battle = battleTable.find(num(a, 0))) {
+            battle->spectators = num(a, 1);
+            battle->locked = num(a, 2);
+            battle->mapHash = str(a, 3);
+            battle->map = str(a, 4);
+            touchBattle(battle->id);
+        }
+    } else if (c == "JOINEDBATTLE") {
+        long long id = num(a, 0);
+        User* user = userTable.find(str(a, 1));
+        Battle* battle = battleTable.find(id);
+        if (user && battle) {
+            leaveBattle(user->name);
+            user->battle = id;
+            battle->members.push_back(user->name);
+            touchUser(user->name);
+            touchBattle(id);
+        }
+    } else if (c == "LEFTBATTLE") {
+        leaveBattle(str(a, 1));
+    } else if (c == "BATTLECLOSED") {
+        closeBattle(num(a, 0));
+    } else if (c == "JOIN") {
+        Channel& channel = channelTable.insert(str(a, 0));
+        channel.name = str(a, 0);
+        touchChannel(channel.name);
+    } else if (c == "CLIENTS") {
+        if (Channel* channel = channelTable.find(str(a, 0))) {
+            channel->users.insert(a.begin() + 1, a.end());
+            touchChannel(channel->name);
+        }
+    } else if (c == "JOINED") {
+        if (Channel* channel = channelTable.find(str(a, 0))) {
+            channel->users.insert(str(a, 1));
+            touchChannel(channel->name);
+        }
+    } else if (c == "LEFT") {
+        if (Channel* channel = channelTable.find(str(a, 0))) {
+            touchChannel(channel->name);
+            if (str(a, 1) == me)
+                channelTable.erase(str(a, 0));
+            else
+                channel->users.erase(str(a, 1));
+        }
+    } else if (c == "FORCELEAVECHANNEL") {
+        touchChannel(str(a, 0));
+        channelTable.erase(str(a, 0));
+    } else if (c == "CHANNELTOPIC") {
+        if (Channel* channel = channelTable.find(str(a, 0))) {
+            channel->topicAuthor = str(a, 1);
+            channel->topic = str(a, 3);
+            touchChannel(channel->name);
+        }
+    } else if (c == "ACCEPTED") {
+        me = str(a, 0);
+    }
+}
+
+// The callers hold the mutex.
+void LobbyState::removeUser(const std::string& name) {
+    if (!userTable.find(name))
+        return;
+    leaveBattle(name);
+    for (std::size_t i = 0; i < channelTable.rows.size(); i++) {
+        if (channelTable.rows[i].users.erase(name))
+            touchChannel(channelTable.keys[i]);
+    }
+    userTable.erase(name);
+    touchUser(name);
+}
+
+void LobbyState::leaveBattle(const std::string& name) {
+    User* user = userTable.find(name);
+    if (!user || user->battle < 0)
+        return;
+    if (Battle* battle = battleTable.find(user->battle)) {
+        auto& members = battle->members;
+        members.erase(std::remove(members.begin(), members.end(), name), members.end());
+        touchBattle(battle->id);
+    }
+    user->battle = -1;
+    touchUser(name);
+}
+
+void LobbyState::closeBattle(long long id) {
+    Battle* battle = battleTable.find(id);
+    if (!battle)
+        return;
+    for (auto& name : battle->members) {
+        if (User* user = userTable.find(name)) {
+            user->battle = -1;
+            touchUser(name);
+        }
+    }
+    battleTable.erase(id);
+    touchBattle(id);
+}
+
+void LobbyState::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    userTable.clear();
+    battleTable.clear();
+    channelTable.clear();
+    me.clear();
+    dirtyUsers.clear();
+    dirtyBattles.clear();
+    dirtyChannels.clear();
+    cleared = trackChanges;
+}
+
+bool LobbyState::hasChanges() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cleared || !dirtyUsers.empty() || !dirtyBattles.empty() || !dirtyChannels.empty();
+}
+
+// A key that is gone by now is reported as removed, whatever happened to it
+// in between.
+LobbyState::Diff LobbyState::takeDiff() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Diff diff;
+    diff.cleared = cleared;
+    cleared = false;
+    for (auto& name : dirtyUsers) {
+        if (const User* user = userTable.find(name))
+            diff.users.push_back(*user);
+        else if (!diff.cleared)
+            diff.removedUsers.push_back(name);
+    }
+    for (long long id : dirtyBattles) {
+        if (const Battle* battle = battleTable.find(id))
+            diff.battles.push_back(*battle);
+        else if (!diff.cleared)
+            diff.removedBattles.push_back(id);
+    }
+    for (auto& name : dirtyChannels) {
+        if (const Channel* channel = channelTable.find(name))
+            diff.channels.push_back(*channel);
+        else if (!diff.cleared)
+            diff.removedChannels.push_back(name);
+    }
+    dirtyUsers.clear();
+    dirtyBattles.clear();
+    dirtyChannels.clear();
+    return diff;
+}
+
+bool LobbyState::Diff::empty() const {
+    return !cleared && users.empty() && battles.empty() && channels.empty() &&
+        removedUsers.empty() && removedChannels.empty() && removedBattles.empty();
+}
+
+LobbyState::Stats LobbyState::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats res = { userTable.rows.size(), battleTable.rows.size(), channelTable.rows.size(), applied };
+    return res;
+}
+
+static bool contains(const std::string& haystack, const std::string& needle) {
+    return std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(), [](char a, char b) {
+        return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+    }) != haystack.end();
+}
+
+static bool matchesSearch(const LobbyState::User& u, const std::string& s) {
+    return contains(u.name, s);
+}
+
+static bool matchesSearch(const LobbyState::Battle& b, const std::string& s) {
+    return contains(b.title, s) || contains(b.founder, s) || contains(b.map, s) || contains(b.game, s);
+}
+
+static bool matchesSearch(const LobbyState::Channel& c, const std::string& s) {
+    return contains(c.name, s) || contains(c.topic, s);
+}
+
+// Filters and sorts pointers to the rows, only the page that is returned is
+// copied. The comparator reads the sort fields itself instead of keeping a
+// copy of them for every match, and only the rows up to the end of the page
+// are sorted.
+template<class Row> std::vector<Row> LobbyState::query(const std::vector<Row>& rows, const Query& q, std::size_t& total) {
+    const auto& fieldList = fields<Row>();
+    auto field = [&](const std::string& name) -> Value (*)(const Row&) {
+        for (auto& f : fieldList) {
+            if (name == f.name)
+                return f.get;
+        }
+        return NULL;
+    };
+    std::vector<std::pair<Value (*)(const Row&), const Value*>> where;
+    for (auto& w : q.where) {
+        auto get = field(w.first);
+        if (!get) {
+            total = 0;
+            return std::vector<Row>();
+        }
+        where.push_back(std::make_pair(get, &w.second));
+    }
+
+    std::vector<const Row*> matched;
+    for (auto& row : rows) {
+        bool match = q.search.empty() || matchesSearch(row, q.search);
+        for (std::size_t i = 0; match && i < where.size(); i++)
+            match = where[i].first(row) == *where[i].second;
+        if (match)
+            matched.push_back(&row);
+    }
+    total = matched.size();
+
+    auto sortKey = field(q.sortBy);
+    auto tieKey = fieldList.front().get;
+    if (!sortKey)
+        sortKey = tieKey;
+    // Ties are broken by the first field, the name or id, so pages are stable.
+    bool descending = q.descending;
+    auto less = [=](const Row* a, const Row* b) {
+        Value ka = sortKey(*a), kb = sortKey(*b);
+        if (!(ka == kb))
+            return descending ? kb < ka : ka < kb;
+        return tieKey(*a) < tieKey(*b);
+    };
+    if (q.offset >= matched.size())
+        return std::vector<Row>();
+    std::size_t end = q.offset + std::min(q.limit, matched.size() - q.offset);
+    std::partial_sort(matched.begin(), matched.begin() + end, matched.end(), less);
+
+    std::vector<Row> res;
+    res.reserve(end - q.offset);
+    for (std::size_t i = q.offset; i < end; i++)
+        res.push_back(*matched[i]);
+    return res;
+}
+
+std::vector<LobbyState::User> LobbyState::users(const Query& q, std::size_t& total) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return query(userTable.rows, q, total);
+}
+
+std::vector<LobbyState::Battle> LobbyState::battles(const Query& q, std::size_t& total) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return query(battleTable.rows, q, total);
+}
+
+std::vector<LobbyState::Channel> LobbyState::channels(const Query& q, std::size_t& total) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return query(channelTable.rows, q, total);
+}
@@ -0,0 +1,134 @@
+#ifndef LOBBYSTATE_H
+#define LOBBYSTATE_H
+
+// A native copy of what the lobby server told us about users, battles and
+// the channels we are in, kept up to date from the protocol stream in the
+// network thread. The GUI thread queries it with filtering, sorting and
+// paging, and instead of following every CLIENTSTATUS it can take a diff of
+// what changed since the last one, where an entity that changed several
+// times shows up once with its latest state.
+
+#include "lobbyprotocol.h"
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class LobbyState {
+public:
+    struct User {
+        std::string name, country, lobbyId;
+        long long cpu, accountId, status, battle;
+    };
+    struct Battle {
+        long long id, type, natType, port, maxPlayers, passworded, rank, spectators, locked;
+        std::string founder, ip, mapHash, engineName, engineVersion, map, title, game;
+        std::vector<std::string> members;
+    };
+    struct Channel {
+        std::string name, topic, topicAuthor;
+        std::set<std::string> users;
+    };
+
+    // A field of a row as seen by queries, either a number or a string.
+    struct Value {
+        Value() : isString(false), num(0) {}
+        Value(long long num) : isString(false), num(num) {}
+        Value(std::string str) : isString(true), num(0), str(std::move(str)) {}
+        bool operator==(const Value& o) const { return isString == o.isString && num == o.num && str == o.str; }
+        bool operator<(const Value& o) const { return isString ? str < o.str : num < o.num; }
+        bool isString;
+        long long num;
+        std::string str;
+    };
+    template<class Row> struct Field {
+        const char* name;
+        Value (*get)(const Row&);
+    };
+    // The queryable fields of User, Battle or Channel rows, also what ends
+    // up in JS.
+    template<class Row> static const std::vector<Field<Row>>& fields();
+
+    struct Query {
+        Query() : descending(false), offset(0), limit(std::size_t(-1)) {}
+        // Field name -> the value it must have.
+        std::vector<std::pair<std::string, Value>> where;
+        // Case insensitive substring of a name, title, map or game.
+        std::string search;
+        std::string sortBy;
+        bool descending;
+        std::size_t offset, limit;
+    };
+    // Rows matching q, sorted and paged. total is the count before paging.
+    std::vector<User> users(const Query& q, std::size_t& total) const;
+    std::vector<Battle> battles(const Query& q, std::size_t& total) const;
+    std::vector<Channel> channels(const Query& q, std::size_t& total) const;
+
+    struct Diff {
+        Diff() : cleared(false) {}
+        bool empty() const;
+        // Everything was dropped before the rest of the diff happened.
+        bool cleared;
+        std::vector<User> users;
+        std::vector<Battle> battles;
+        std::vector<Channel> channels;
+        std::vector<std::string> removedUsers, removedChannels;
+        std::vector<long long> removedBattles;
+    };
+
+    // Changes are only remembered for diffs with trackChanges.
+    explicit LobbyState(bool trackChanges) : applied(0), trackChanges(trackChanges), cleared(false) {}
+
+    // Called from the network thread for every line from the server.
+    void apply(const LobbyCommand&);
+    // Forgets everything, e.g. after a reconnect.
+    void clear();
+    bool hasChanges() const;
+    Diff takeDiff();
+
+    struct Stats {
+        std::size_t users, battles, channels;
+        unsigned long long applied;
+    };
+    Stats stats() const;
+private:
+    // Rows in a vector, found through a key -> position index. Removal moves
+    // the last row into the gap.
+    template<class Key, class Row> struct Table {
+        std::vector<Row> rows;
+        std::vector<Key> keys;
+        std::unordered_map<Key, std::size_t> index;
+        Row* find(const Key&);
+        const Row* find(const Key&) const;
+        Row& insert(const Key&);
+        bool erase(const Key&);
+        void clear() { rows.clear(); keys.clear(); index.clear(); }
+    };
+    template<class Row> static std::vector<Row> query(const std::vector<Row>&, const Query&, std::size_t& total);
+
+    void removeUser(const std::string& name);
+    void leaveBattle(const std::string& user);
+    void closeBattle(long long id);
+    void touchUser(const std::string& name) { if (trackChanges) dirtyUsers.insert(name); }
+    void touchBattle(long long id) { if (trackChanges) dirtyBattles.insert(id); }
+    void touchChannel(const std::string& name) { if (trackChanges) dirtyChannels.insert(name); }
+
+    mutable std::mutex mutex;
+    Table<std::string, User> userTable;
+    Table<long long, Battle> battleTable;
+    Table<std::string, Channel> channelTable;
+    // Our own name, from ACCEPTED.
+    std::string me;
+    unsigned long long applied;
+    bool trackChanges, cleared;
+    std::unordered_set<std::string> dirtyUsers, dirtyChannels;
+    std::unordered_set<long long> dirtyBattles;
+};
+
+template<> const std::vector<LobbyState::Field<LobbyState::User>>& LobbyState::fields<LobbyState::User>();
+template<> const std::vector<LobbyState::Field<LobbyState::Battle>>& LobbyState::fields<LobbyState::Battle>();
+template<> const std::vector<LobbyState::Field<LobbyState::Channel>>& LobbyState::fields<LobbyState::Channel>();
+
+#endif // LOBBYSTATE_H
@@ -16,6 +16,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include "ufstream.h"
+#include "nativeevent.h"
 
 class Logger {
 public:
@@ -51,8 +52,8 @@ public:
     template<typename... Args>
     void error(Args... args) { putLevel(level::error, args...); }
 
-    struct LogEvent : QEvent {
-        LogEvent(level lev, std::string msg) : QEvent(QEvent::Type(TypeId)), lev(lev), msg(msg) {}
+    struct LogEvent : NativeEvent {
+        LogEvent(level lev, std::string msg) : NativeEvent(TypeId, EventClass::log), lev(lev), msg(std::move(msg)) {}
         level lev;
         std::string msg;
         static const int TypeId = QEvent::User + 2; // magic numbers ftw!
@@ -89,7 +90,8 @@ private:
         if (fileStream.good())
             fileStream << std::endl;
         if (eventReceiver)
-            QCoreApplication::postEvent(eventReceiver, new LogEvent(lev, msgString.str()));
+            // Errors are shown to the user, they mustn't get lost.
+            EventScheduler::post(eventReceiver, new LogEvent(lev, msgString.str()), lev != level::error);
     }
     void put(std::ostringstream&) {}
     template<typename T, typename... Args>
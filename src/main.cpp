@@ -1,9 +1,11 @@
 #include <QApplication>
 #include <curl/curl.h>
+#include <iostream>
 #ifdef Q_OS_LINUX
     #include <mpg123.h>
 #endif
 #include "weblobbywindow.h"
+#include "trace.h"
 
 int main(int argc, char *argv[])
 {
@@ -13,6 +15,16 @@ int main(int argc, char *argv[])
     #endif
     QApplication app(argc, argv);
 
+    // -trace [file] records a timeline of all threads and writes it as Chrome
+    // trace event JSON on exit, by default into springHome/weblobby/logs.
+    auto args = app.arguments();
+    int traceIndex = args.indexOf("-trace");
+    if (traceIndex >= 0) {
+        if (traceIndex + 1 < args.length() && !args[traceIndex+1].startsWith("-"))
+            Trace::setDumpPath(args[traceIndex+1].toStdWString());
+        Trace::start();
+    }
+
     WebLobbyWindow webLobbyWindow;
     #if defined Q_OS_WINDOWS
         webLobbyWindow.setWindowIcon(app.windowIcon());
@@ -22,6 +34,12 @@ int main(int argc, char *argv[])
     webLobbyWindow.showMaximized();
 
     auto exitCode = app.exec();
+    if (Trace::enabled() && !Trace::dumpPath().empty()) {
+        if (Trace::dump())
+            std::cout << "Trace written to " << Trace::dumpPath() << std::endl;
+        else
+            std::cerr << "Could not write trace to " << Trace::dumpPath() << std::endl;
+    }
     #ifdef Q_OS_LINUX
         mpg123_exit();
     #endif
@@ -0,0 +1,199 @@
+#include "nativeevent.h"
+#include "trace.h"
+#include <atomic>
+#include <map>
+#include <new>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace {
+
+// pending is the total over all sources, for the stats.
+struct ClassState {
+    std::atomic<unsigned long long> posted, dropped, coalesced;
+    std::atomic<unsigned int> pending, limit;
+};
+
+// Progress and log events are cheap to lose, protocol lines and unitsync
+// results are not, so those are never dropped by default.
+struct SchedulerState {
+    ClassState classes[eventClassCount];
+    // Pending events per class and source, a source is only present while
+    // it has some. The limit is checked and the count raised under the
+    // mutex, so posting threads can't overshoot it together.
+    boost::mutex sourceMutex;
+    std::map<std::pair<int, std::string>, unsigned int> sources;
+    boost::mutex coalesceMutex;
+    // key -> latest value, present while an event for the key is pending.
+    std::map<std::string, std::string> coalesced;
+
+    SchedulerState() {
+        const unsigned int limits[eventClassCount] = { 0, 0, 20000, 1000, 1000 };
+        for (int i = 0; i < eventClassCount; i++) {
+            classes[i].posted = classes[i].dropped = classes[i].coalesced = 0;
+            classes[i].pending = 0;
+            classes[i].limit = limits[i];
+        }
+    }
+};
+
+// Never destroyed, events may still be freed during static destruction.
+SchedulerState& state() {
+    static SchedulerState* s = new SchedulerState;
+    return *s;
+}
+
+// Free lists of event sized blocks. Events are allocated in the posting
+// thread and freed in the GUI thread, so each size class is shared and
+// guarded by a mutex that's only held for a push or a pop.
+class EventPool {
+public:
+    static const std::size_t granularity = 64, sizeClasses = 4, maxFree = 4096;
+
+    void* allocate(std::size_t size) {
+        std::size_t cls = (size - 1) / granularity;
+        if (cls < sizeClasses) {
+            SizeClass& sc = classes[cls];
+            boost::lock_guard<boost::mutex> lock(sc.mutex);
+            if (!sc.free.empty()) {
+                void* p = sc.free.back();
+                sc.free.pop_back();
+                return p;
+            }
+            return ::operator new((cls + 1) * granularity);
+        }
+        return ::operator new(size);
+    }
+    void deallocate(void* p, std::size_t size) {
+        std::size_t cls = (size - 1) / granularity;
+        if (cls < sizeClasses) {
+            SizeClass& sc = classes[cls];
+            boost::lock_guard<boost::mutex> lock(sc.mutex);
+            if (sc.free.size() < maxFree) {
+                sc.free.push_back(p);
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+private:
+    struct SizeClass {
+        boost::mutex mutex;
+        std::vector<void*> free;
+    };
+    SizeClass classes[sizeClasses];
+};
+
+EventPool& pool() {
+    static EventPool* p = new EventPool;
+    return *p;
+}
+
+// Qt delivers posted events with a higher priority first. Everything stays
+// at or below NormalEventPriority so that Qt's own events aren't delayed.
+int priority(EventClass cls) {
+    return Qt::NormalEventPriority - int(cls);
+}
+
+}
+
+void* NativeEvent::operator new(std::size_t size) {
+    return pool().allocate(size);
+}
+
+// QEvent's destructor is virtual, so size is the one of the dynamic type.
+void NativeEvent::operator delete(void* p, std::size_t size) {
+    if (p)
+        pool().deallocate(p, size);
+}
+
+NativeEvent::~NativeEvent() {
+    if (queued)
+        EventScheduler::delivered(cls, source);
+}
+
+bool EventScheduler::post(QObject* receiver, NativeEvent* evt, bool droppable) {
+    SchedulerState& s = state();
+    ClassState& cs = s.classes[int(evt->cls)];
+    bool drop = false;
+    {
+        boost::lock_guard<boost::mutex> lock(s.sourceMutex);
+        unsigned int& pending = s.sources[std::make_pair(int(evt->cls), evt->source)];
+        unsigned int limit = cs.limit;
+        if (droppable && limit != 0 && pending >= limit)
+            drop = true;
+        else
+            pending++;
+    }
+    if (drop) {
+        cs.dropped++;
+        delete evt;
+        return false;
+    }
+    cs.posted++;
+    unsigned int pending = ++cs.pending;
+    Trace::counter(className(evt->cls), pending);
+    evt->queued = true;
+    evt->postTime = std::chrono::steady_clock::now();
+    QCoreApplication::postEvent(receiver, evt, priority(evt->cls));
+    return true;
+}
+
+void EventScheduler::postCoalesced(QObject* receiver, NativeEvent* evt, const std::string& key, const std::string& value) {
+    SchedulerState& s = state();
+    {
+        boost::lock_guard<boost::mutex> lock(s.coalesceMutex);
+        auto it = s.coalesced.find(key);
+        if (it != s.coalesced.end()) {
+            it->second = value;
+            s.classes[int(evt->cls)].coalesced++;
+            delete evt;
+            return;
+        }
+        s.coalesced.insert(std::make_pair(key, value));
+    }
+    evt->coalesceKey = key;
+    if (!post(receiver, evt, false))
+        takeCoalesced(key);
+}
+
+std::string EventScheduler::takeCoalesced(const std::string& key) {
+    SchedulerState& s = state();
+    boost::lock_guard<boost::mutex> lock(s.coalesceMutex);
+    auto it = s.coalesced.find(key);
+    if (it == s.coalesced.end())
+        return "";
+    std::string value = std::move(it->second);
+    s.coalesced.erase(it);
+    return value;
+}
+
+void EventScheduler::setLimit(EventClass cls, unsigned int limit) {
+    state().classes[int(cls)].limit = limit;
+}
+
+EventScheduler::Stats EventScheduler::stats(EventClass cls) {
+    ClassState& cs = state().classes[int(cls)];
+    return Stats { cs.posted, cs.dropped, cs.coalesced, cs.pending, cs.limit };
+}
+
+const char* EventScheduler::className(EventClass cls) {
+    switch (cls) {
+    case EventClass::protocol: return "protocol";
+    case EventClass::unitsync: return "unitsync";
+    case EventClass::process: return "process";
+    case EventClass::progress: return "progress";
+    case EventClass::log: return "log";
+    }
+    return "";
+}
+
+void EventScheduler::delivered(EventClass cls, const std::string& source) {
+    SchedulerState& s = state();
+    s.classes[int(cls)].pending--;
+    boost::lock_guard<boost::mutex> lock(s.sourceMutex);
+    auto it = s.sources.find(std::make_pair(int(cls), source));
+    if (it != s.sources.end() && --it->second == 0)
+        s.sources.erase(it);
+}
@@ -0,0 +1,77 @@
+#ifndef NATIVEEVENT_H
+#define NATIVEEVENT_H
+
+// Events posted from the network, process, download and unitsync threads to
+// the GUI thread all go through EventScheduler so that a chatty source can't
+// bury the lobby protocol under its own events.
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <string>
+#include <chrono>
+
+// In the order of priority, highest first.
+enum class EventClass {
+    protocol,
+    unitsync,
+    process,
+    progress,
+    log
+};
+const int eventClassCount = 5;
+
+// Base for all events posted through EventScheduler. Their TypeIds are in the
+// range QEvent::User + 1 ... QEvent::User + 15. Payloads are moved in, not
+// copied, and the event objects themselves are recycled through a pool since
+// a login burst creates them by the thousands.
+struct NativeEvent : QEvent {
+    NativeEvent(int type, EventClass cls, std::string source = std::string()) : QEvent(QEvent::Type(type)), cls(cls),
+        source(std::move(source)), queued(false) {}
+    // Only the posted instance counts as pending.
+    NativeEvent(const NativeEvent& e) : QEvent(e), cls(e.cls), source(e.source), coalesceKey(e.coalesceKey),
+        queued(false) {}
+    ~NativeEvent();
+    static void* operator new(std::size_t);
+    static void operator delete(void*, std::size_t);
+    EventClass cls;
+    // The connection, command or download the event comes from, queue
+    // limits apply to each source of a class separately.
+    std::string source;
+    // Set by EventScheduler::postCoalesced(), the payload is then retrieved
+    // with EventScheduler::takeCoalesced(coalesceKey).
+    std::string coalesceKey;
+    bool queued;
+    std::chrono::steady_clock::time_point postTime;
+};
+
+inline bool isNativeEvent(const QEvent* evt) {
+    return evt->type() > QEvent::User && evt->type() < QEvent::User + 16;
+}
+
+class EventScheduler {
+public:
+    // Posts evt to receiver with the priority of its class. If its source
+    // already has as many events of the class pending as the class limit
+    // allows and the event is droppable, it is deleted and counted as
+    // dropped instead. A noisy source only fills its own share.
+    static bool post(QObject* receiver, NativeEvent* evt, bool droppable = true);
+    // Stores value as the latest one for key and posts evt unless an event
+    // for the same key is still pending, in which case evt is deleted.
+    static void postCoalesced(QObject* receiver, NativeEvent* evt, const std::string& key, const std::string& value);
+    static std::string takeCoalesced(const std::string& key);
+
+    // 0 means no limit.
+    static void setLimit(EventClass, unsigned int);
+
+    struct Stats {
+        unsigned long long posted, dropped, coalesced;
+        unsigned int pending, limit;
+    };
+    static Stats stats(EventClass);
+    static const char* className(EventClass);
+private:
+    friend struct NativeEvent;
+    static void delivered(EventClass, const std::string& source);
+};
+
+#endif // NATIVEEVENT_H
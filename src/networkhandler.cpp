@@ -1,79 +1,1135 @@
 #include "lobbyinterface.h"
+#include "trace.h"
 #include <QCoreApplication>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
 
 namespace asio = boost::asio;
 namespace ip = asio::ip;
 
-void NetworkHandler::connect(std::string host, unsigned int port) {
-    logger.info("Connecting to lobby server on ", host, ":", port);
+// One lobby connection: connecting, reading, the send queue and the link
+// monitor. Everything here runs in the network thread except for the stats
+// getters, which only read atomics or take statsMutex.
+class NetworkHandler::Connection {
+public:
+    struct Settings {
+        unsigned int rate, burst, pingInterval, stallWindow;
+    };
+    Connection(asio::io_service& service, std::string name, EndpointCache& cache, const Settings& settings,
+        QObject* eventReceiver, Logger& logger);
+
+    void connect(std::string host, unsigned int port, ConnectOptions options);
+    void disconnect();
+    void startCapture(const boost::filesystem::path&);
+    void stopCapture();
+    // Feeds the received lines of a capture through deliver() instead of
+    // reading the socket, speed times as fast as they were recorded or as
+    // fast as possible with a speed of 0.
+    void replay(const boost::filesystem::path&, ConnectOptions options, double speed);
+    void send(std::string&& msg);
+    void setPacing(unsigned int rate, unsigned int burst);
+    void setLinkMonitor(unsigned int interval, unsigned int stallWindow);
+    // Between connect() and disconnect(), whether connected or not.
+    bool isActive() const { return active; }
+    // Calls drained once no handler of this connection is pending any more,
+    // right away if none is. Only for a connection that was disconnected
+    // for good, it mustn't be destroyed before.
+    void whenDrained(std::function<void()> drained);
+
+    SendStats sendStats() const;
+    TransportStats transportStats() const;
+    ConnectStats connectStats() const;
+    LinkStats linkStats() const;
+    std::shared_ptr<LobbyState> lobbyState() const;
+    std::shared_ptr<ProtocolProfiler> protocolProfiler() const { return profiler; }
+private:
+    void startConnect();
+    void addCandidates(const std::vector<ip::tcp::endpoint>&);
+    void launchAttempt();
+    void onConnected(const ip::tcp::endpoint&);
+    void connectFailed(const std::string& msg);
+    void scheduleReconnect();
+    void closeAttempts();
+    void schedulePing();
+    void checkLink();
+    bool handlePong(const std::string& line, std::chrono::steady_clock::time_point now);
+    void startRead();
+    void onRead(const boost::system::error_code&, std::size_t);
+    void deliver(std::vector<std::string>&& lines);
+    void post(ReadEvent* evt);
+    void logProfile();
+    void setOptions(ConnectOptions options);
+    void replayStep(unsigned int gen);
+    void scheduleDiff();
+    bool negotiate(std::vector<std::string>& lines);
+    bool decompress(const char* data, std::size_t len, std::vector<std::string>& lines);
+    void endNegotiation(bool compressed);
+    void scheduleWrite();
+    void onWrite(const boost::system::error_code&, std::size_t);
+    void clearSendQueue();
+    static bool isInteractive(const std::string& msg);
+
+    // Every completion handler is wrapped with track(), so the connection
+    // knows when it can go away.
+    template<class Handler> struct Tracked {
+        Connection* conn;
+        Handler handler;
+        template<class... Args> void operator()(Args&&... args) {
+            handler(std::forward<Args>(args)...);
+            conn->untrack();
+        }
+    };
+    template<class Handler> Tracked<Handler> track(Handler handler) {
+        pendingHandlers++;
+        return Tracked<Handler> { this, std::move(handler) };
+    }
+    void untrack();
+
+    asio::io_service& service;
+    // Events carry the name, log lines the tag.
+    std::string name, tag;
+    ip::tcp::resolver resolver;
+    ip::tcp::socket socket;
+    asio::steady_timer pacingTimer, negotiateTimer, staggerTimer, reconnectTimer;
+    // generation changes with every connection attempt so that handlers of
+    // an abandoned one can tell.
+    std::string host;
+    unsigned int port;
+    ConnectOptions options;
+    unsigned int generation;
+    std::vector<ip::tcp::endpoint> candidates;
+    std::size_t nextCandidate;
+    std::vector<std::shared_ptr<ip::tcp::socket>> attempts;
+    // Whether the next attempt is already scheduled by staggerTimer.
+    bool staggerPending;
+    bool resolving;
+    // How many of the candidates came from the cache, they come first.
+    std::size_t cachedCandidates;
+    std::string lastConnectError;
+    std::chrono::steady_clock::time_point connectStart;
+    unsigned int reconnectAttempt;
+    std::minstd_rand random;
+    EndpointCache& cache;
+    asio::steady_timer pingTimer;
+    // Ping ids start high, away from the ones JS uses.
+    unsigned int pingInterval, stallWindow, nextPingId;
+    // Ping id -> when it was queued.
+    std::map<unsigned int, std::chrono::steady_clock::time_point> pendingPings;
+    std::chrono::steady_clock::time_point lastReceived;
+    LineFramer framer;
+    // Only there if lines are delivered tokenized.
+    std::unique_ptr<LobbyTokenizer> tokenizer;
+    // Only there with mirrorState, replaced under statsMutex.
+    std::shared_ptr<LobbyState> state;
+    asio::steady_timer diffTimer;
+    bool diffPending;
+    CaptureWriter capture;
+    const std::shared_ptr<ProtocolProfiler> profiler;
+    asio::steady_timer replayTimer;
+    std::shared_ptr<std::vector<CaptureRecord>> replayRecords;
+    std::size_t replayPos;
+    double replaySpeed;
+    std::chrono::steady_clock::time_point replayStart;
+    unsigned long long replayLines, replayBytes;
+    enum class Transport { plain, negotiating, deflate };
+    Transport transport;
+    DeflateStream zstream;
+    // Compressed data is read here and inflated into framer.
+    std::vector<char> rawBuf;
+    std::string deflated;
+    std::deque<std::string> sendQueue;
+    std::vector<std::string> writing;
+    std::vector<asio::const_buffer> writeBufs;
+    bool writeInProgress, pacingWait;
+    double rate, burst, tokens;
+    std::chrono::steady_clock::time_point lastRefill;
+    std::atomic<unsigned long long> queuedMessages, queuedBytes, inFlightBytes;
+    std::atomic<unsigned long long> sentMessages, sentBytes, pacedWaits;
+    std::atomic<bool> active, compressed;
+    std::atomic<unsigned long long> bytesIn, wireBytesIn, wireBytesOut;
+    std::atomic<unsigned long long> connects, connectFailures, reconnects;
+    std::atomic<long long> lastConnectUs, lastResolveUs;
+    std::atomic<unsigned int> lastEndpointsTried;
+    std::atomic<bool> lastFromCache;
+    std::atomic<unsigned long long> pingsSent, pongsReceived, pingsLost, stalls;
+    // Guards the stats that aren't plain numbers.
+    mutable boost::mutex statsMutex;
+    std::string lastEndpoint;
+    std::deque<long long> rttSamples;
+    long long jitterUs;
+    unsigned int pendingHandlers;
+    std::function<void()> drained;
+    QObject* eventReceiver;
+    Logger& logger;
+};
+
+NetworkHandler::Connection::Connection(asio::io_service& service, std::string name, EndpointCache& cache,
+        const Settings& settings, QObject* eventReceiver, Logger& logger) :
+        service(service), name(name), tag(name.empty() ? "" : "[" + name + "] "), resolver(service), socket(service),
+        pacingTimer(service), negotiateTimer(service), staggerTimer(service), reconnectTimer(service),
+        port(0), generation(0), nextCandidate(0), staggerPending(false), resolving(false), cachedCandidates(0), reconnectAttempt(0),
+        random(std::time(NULL)), cache(cache), pingTimer(service), pingInterval(settings.pingInterval),
+        stallWindow(settings.stallWindow), nextPingId(1u << 30), diffTimer(service), diffPending(false),
+        profiler(std::make_shared<ProtocolProfiler>()), replayTimer(service), replayPos(0), replaySpeed(0), replayLines(0), replayBytes(0),
+        transport(Transport::plain), rawBuf(65536),
+        writeInProgress(false), pacingWait(false), rate(settings.rate), burst(std::max(settings.burst, 1u)),
+        tokens(burst), lastRefill(std::chrono::steady_clock::now()), queuedMessages(0), queuedBytes(0),
+        inFlightBytes(0), sentMessages(0), sentBytes(0), pacedWaits(0), active(false), compressed(false),
+        bytesIn(0),
+        wireBytesIn(0), wireBytesOut(0), connects(0), connectFailures(0), reconnects(0), lastConnectUs(0),
+        lastResolveUs(0), lastEndpointsTried(0), lastFromCache(false), pingsSent(0), pongsReceived(0),
+        pingsLost(0), stalls(0), jitterUs(0), pendingHandlers(0), eventReceiver(eventReceiver), logger(logger) {}
+
+void NetworkHandler::Connection::connect(std::string host, unsigned int port, ConnectOptions options) {
+    this->host = host;
+    this->port = port;
+    setOptions(options);
+    reconnectAttempt = 0;
+    active = true;
+    startConnect();
+}
+
+void NetworkHandler::Connection::setOptions(ConnectOptions options) {
+    this->options = options;
+    if(options.tokenize || options.batchLogin)
+        tokenizer.reset(new LobbyTokenizer(options.batchLogin));
+    else
+        tokenizer.reset();
+    {
+        boost::lock_guard<boost::mutex> lock(statsMutex);
+        if(options.mirrorState)
+            state = std::make_shared<LobbyState>(options.stateDiffInterval > 0);
+        else
+            state.reset();
+    }
+}
+
+// Cached endpoints are raced right away, whatever DNS returns later joins
+// the race.
+void NetworkHandler::Connection::startConnect() {
+    logger.info(tag, "Connecting to lobby server on ", host, ":", port);
+    unsigned int gen = ++generation;
+    closeAttempts();
+    socket.close();
+    // Whatever was queued for the old socket (a LOGIN, held back during
+    // negotiation or pacing) mustn't go out before the page logs in again.
+    writing.clear();
+    clearSendQueue();
+    reconnectTimer.cancel();
+    candidates.clear();
+    nextCandidate = 0;
+    lastConnectError = "Could not connect to lobby server: no addresses";
+    connectStart = std::chrono::steady_clock::now();
+    addCandidates(cache.lookup(host, port));
+    cachedCandidates = candidates.size();
+
+    resolving = true;
+    auto resolveStart = Trace::clock::now();
     resolver.async_resolve({ host, std::to_string(port) },
-        [=](const boost::system::error_code& ec, ip::udp::resolver::iterator it){
+        track([=](const boost::system::error_code& ec, ip::tcp::resolver::iterator it){
+        if(gen != generation)
+            return;
+        auto now = Trace::clock::now();
+        Trace::complete("resolve", resolveStart, now, host);
+        lastResolveUs = std::chrono::duration_cast<std::chrono::microseconds>(now - resolveStart).count();
+        resolving = false;
+
+        if(ec) {
+            lastConnectError = "Could not resolve host: " + ec.message();
+            if(socket.is_open())
+                return;
+            // Cached endpoints may still get through.
+            if(attempts.empty() && nextCandidate == candidates.size())
+                connectFailed(lastConnectError);
+            return;
+        }
+        std::vector<ip::tcp::endpoint> resolved;
+        for(; it != ip::tcp::resolver::iterator(); ++it)
+            resolved.push_back(it->endpoint());
+        cache.storeResolved(host, port, resolved);
+        if(socket.is_open())
+            return;
+        addCandidates(resolved);
+        if(attempts.empty() && nextCandidate == candidates.size())
+            connectFailed(lastConnectError);
+    }));
+}
+
+// Address families are interleaved so that a broken IPv6 (or IPv4) path
+// only costs one stagger interval.
+void NetworkHandler::Connection::addCandidates(const std::vector<ip::tcp::endpoint>& endpoints) {
+    std::vector<ip::tcp::endpoint> v6, v4;
+    for(auto& endpoint : endpoints) {
+        if(std::find(candidates.begin(), candidates.end(), endpoint) != candidates.end())
+            continue;
+        (endpoint.address().is_v6() ? v6 : v4).push_back(endpoint);
+    }
+    for(std::size_t i = 0; i < std::max(v6.size(), v4.size()); i++) {
+        if(i < v6.size())
+            candidates.push_back(v6[i]);
+        if(i < v4.size())
+            candidates.push_back(v4[i]);
+    }
+    // Without a pending stagger the race has run out of candidates, the new
+    // ones start right away instead of waiting for the ones still trying.
+    if(!socket.is_open() && !staggerPending && nextCandidate < candidates.size())
+        launchAttempt();
+}
 
+void NetworkHandler::Connection::launchAttempt() {
+    if(nextCandidate >= candidates.size())
+        return;
+    unsigned int gen = generation;
+    ip::tcp::endpoint endpoint = candidates[nextCandidate++];
+    auto attempt = std::make_shared<ip::tcp::socket>(service);
+    attempts.push_back(attempt);
+    auto attemptStart = Trace::clock::now();
+    // Losers of a race that was won get operation_aborted, as their socket
+    // was closed, and must leave the winner alone.
+    attempt->async_connect(endpoint, track([=](const boost::system::error_code& ec){
+        if(gen != generation || ec == asio::error::operation_aborted || socket.is_open())
+            return;
+        Trace::complete("connect attempt", attemptStart, Trace::clock::now(), endpoint.address().to_string());
+        auto it = std::find(attempts.begin(), attempts.end(), attempt);
+        if(it == attempts.end())
+            return;
+        attempts.erase(it);
         if(ec) {
-            socket.close();
-            std::string msg = "Could not resolve host: " + ec.message();
-            logger.error(msg);
-            QCoreApplication::postEvent(eventReceiver, new ErrorEvent(msg));
+            lastConnectError = "Could not connect to lobby server: " + ec.message();
+            logger.debug(tag, "Connecting to ", endpoint.address().to_string(), " failed: ", ec.message());
+            if(nextCandidate < candidates.size())
+                launchAttempt();
+            else if(attempts.empty() && !resolving)
+                connectFailed(lastConnectError);
             return;
         }
-        socket.async_connect({ it->endpoint().address(), it->endpoint().port() },
-            [=](const boost::system::error_code& ec){
-
-            if(ec) {
-                socket.close();
-                std::string msg = "Could not connect to lobby server: " + ec.message();
-                logger.error(msg);
-                QCoreApplication::postEvent(eventReceiver, new ErrorEvent(msg));
-            } else {
-                asio::async_read_until(socket, readBuf, '\n', boost::bind(&NetworkHandler::onRead, this, _1, _2));
+        staggerTimer.cancel();
+        closeAttempts();
+        socket = std::move(*attempt);
+        onConnected(endpoint);
+    }));
+
+    // Rearming aborts the previous wait, that one mustn't clear the flag.
+    staggerPending = true;
+    staggerTimer.expires_from_now(std::chrono::milliseconds(250));
+    staggerTimer.async_wait(track([=](const boost::system::error_code& ec){
+        if(ec)
+            return;
+        staggerPending = false;
+        if(gen == generation && !socket.is_open())
+            launchAttempt();
+    }));
+}
+
+void NetworkHandler::Connection::closeAttempts() {
+    for(auto& attempt : attempts)
+        attempt->close();
+    attempts.clear();
+    staggerTimer.cancel();
+    staggerPending = false;
+}
+
+void NetworkHandler::Connection::onConnected(const ip::tcp::endpoint& endpoint) {
+    auto now = std::chrono::steady_clock::now();
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(now - connectStart).count();
+    Trace::complete("connect", connectStart, now, host);
+    connects++;
+    lastConnectUs = us;
+    lastEndpointsTried = nextCandidate;
+    bool cached = std::size_t(std::find(candidates.begin(), candidates.end(), endpoint) - candidates.begin()) < cachedCandidates;
+    lastFromCache = cached;
+    {
+        boost::lock_guard<boost::mutex> lock(statsMutex);
+        lastEndpoint = endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+    }
+    logger.info(tag, "Connected to ", endpoint.address().to_string(), " in ", us / 1000, " ms, ",
+        nextCandidate, " endpoint(s) tried", cached ? ", cached address" : "");
+    cache.markGood(host, port, endpoint);
+    reconnectAttempt = 0;
+    pendingPings.clear();
+    lastReceived = now;
+    schedulePing();
+
+    // Lines are written whole, there's nothing to gain from Nagle.
+    boost::system::error_code optEc;
+    socket.set_option(ip::tcp::no_delay(true), optEc);
+    socket.set_option(asio::socket_base::keep_alive(true), optEc);
+    framer.reset();
+    if(tokenizer)
+        tokenizer->reset();
+    if(state)
+        state->clear();
+    zstream.reset();
+    compressed = false;
+    transport = Transport::plain;
+    if(options.compress) {
+        // Sends are held back until the server has answered.
+        static const std::string request = "COMPRESS deflate\n";
+        transport = Transport::negotiating;
+        asio::async_write(socket, asio::buffer(request), track([](const boost::system::error_code&, std::size_t){}));
+        negotiateTimer.expires_from_now(std::chrono::seconds(5));
+        negotiateTimer.async_wait(track([this](const boost::system::error_code& ec){
+            if(!ec && transport == Transport::negotiating) {
+                logger.warning(tag, "Lobby server didn't answer the compression request, continuing uncompressed");
+                endNegotiation(false);
             }
-        });
-    });
+        }));
+    }
+    startRead();
+}
+
+// The socket is always closed before ErrorEvent is posted, the send queue
+// is dropped with it.
+void NetworkHandler::Connection::connectFailed(const std::string& msg) {
+    closeAttempts();
+    socket.close();
+    writing.clear();
+    clearSendQueue();
+    negotiateTimer.cancel();
+    pingTimer.cancel();
+    connectFailures++;
+    logger.error(tag, msg);
+    logProfile();
+    EventScheduler::post(eventReceiver, new ErrorEvent(name, msg), false);
+    if(options.reconnect)
+        scheduleReconnect();
+}
+
+// Exponential backoff from 1 s up to a minute with full jitter on the upper
+// half, so that clients dropped together don't come back together.
+void NetworkHandler::Connection::scheduleReconnect() {
+    unsigned int maxMs = std::min(1000u << std::min(reconnectAttempt, 6u), 60000u);
+    unsigned int delayMs = maxMs / 2 + random() % (maxMs / 2 + 1);
+    reconnectAttempt++;
+    logger.info(tag, "Reconnecting to lobby server in ", delayMs, " ms");
+    unsigned int gen = generation;
+    reconnectTimer.expires_from_now(std::chrono::milliseconds(delayMs));
+    reconnectTimer.async_wait(track([=](const boost::system::error_code& ec){
+        if(!ec && gen == generation) {
+            reconnects++;
+            startConnect();
+        }
+    }));
+}
+
+void NetworkHandler::Connection::setLinkMonitor(unsigned int interval, unsigned int stallWindow) {
+    pingInterval = interval;
+    this->stallWindow = stallWindow;
+    if(socket.is_open())
+        schedulePing();
+    else
+        pingTimer.cancel();
+}
+
+NetworkHandler::LinkStats NetworkHandler::Connection::linkStats() const {
+    LinkStats res = LinkStats();
+    res.pingsSent = pingsSent;
+    res.pongsReceived = pongsReceived;
+    res.pingsLost = pingsLost;
+    res.stalls = stalls;
+    std::vector<long long> sorted;
+    {
+        boost::lock_guard<boost::mutex> lock(statsMutex);
+        if(rttSamples.empty())
+            return res;
+        res.lastRttUs = rttSamples.back();
+        res.jitterUs = jitterUs;
+        sorted.assign(rttSamples.begin(), rttSamples.end());
+    }
+    std::sort(sorted.begin(), sorted.end());
+    long long sum = 0;
+    for(long long rtt : sorted)
+        sum += rtt;
+    res.samples = sorted.size();
+    res.minRttUs = sorted.front();
+    res.maxRttUs = sorted.back();
+    res.meanRttUs = sum / (long long)sorted.size();
+    res.p50RttUs = sorted[sorted.size() / 2];
+    res.p99RttUs = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+    return res;
+}
+
+void NetworkHandler::Connection::schedulePing() {
+    if(pingInterval == 0)
+        return;
+    unsigned int gen = generation;
+    pingTimer.expires_from_now(std::chrono::milliseconds(pingInterval));
+    pingTimer.async_wait(track([=](const boost::system::error_code& ec){
+        if(ec || gen != generation || !socket.is_open())
+            return;
+        checkLink();
+        if(socket.is_open())
+            schedulePing();
+    }));
+}
+
+// The ping queues behind whatever was sent before it and may use the chat
+// reserve of the bucket, so the RTT also includes the time it waited in the
+// send queue and for pacing, not just the network and the server.
+void NetworkHandler::Connection::checkLink() {
+    auto now = std::chrono::steady_clock::now();
+    auto window = std::chrono::milliseconds(stallWindow);
+    bool lost = false;
+    for(auto it = pendingPings.begin(); it != pendingPings.end();) {
+        if(now - it->second >= window) {
+            pingsLost++;
+            lost = true;
+            it = pendingPings.erase(it);
+        } else {
+            it++;
+        }
+    }
+    if(lost && now - lastReceived >= window) {
+        stalls++;
+        connectFailed("Lobby server stopped responding, nothing received for " +
+            std::to_string(std::chrono::duration_cast<std::chrono::seconds>(now - lastReceived).count()) + " s");
+        return;
+    }
+    if(transport == Transport::negotiating)
+        return;
+
+    unsigned int id = nextPingId++;
+    std::string ping = "#" + std::to_string(id) + " PING\n";
+    pendingPings[id] = now;
+    pingsSent++;
+    queuedMessages++;
+    queuedBytes += ping.size();
+    sendQueue.push_back(std::move(ping));
+    scheduleWrite();
+}
+
+// Returns true if line is the answer to one of our pings.
+bool NetworkHandler::Connection::handlePong(const std::string& line, std::chrono::steady_clock::time_point now) {
+    std::size_t space = line.find(' ');
+    if(space == std::string::npos || line.compare(space + 1, 4, "PONG") != 0)
+        return false;
+    auto it = pendingPings.find(std::strtoul(line.c_str() + 1, NULL, 10));
+    if(it == pendingPings.end())
+        return false;
+    long long rtt = std::chrono::duration_cast<std::chrono::microseconds>(now - it->second).count();
+    pendingPings.erase(it);
+    pongsReceived++;
+    boost::lock_guard<boost::mutex> lock(statsMutex);
+    if(!rttSamples.empty())
+        jitterUs += (std::abs(rtt - rttSamples.back()) - jitterUs) / 16;
+    rttSamples.push_back(rtt);
+    if(rttSamples.size() > rttWindow)
+        rttSamples.pop_front();
+    return true;
+}
+
+void NetworkHandler::Connection::startRead() {
+    if(transport == Transport::deflate)
+        socket.async_read_some(asio::buffer(rawBuf), track(boost::bind(&NetworkHandler::Connection::onRead, this, _1, _2)));
+    else
+        socket.async_read_some(framer.prepare(), track(boost::bind(&NetworkHandler::Connection::onRead, this, _1, _2)));
 }
 
 // Called in the network thread.
-void NetworkHandler::onRead(const boost::system::error_code& ec, std::size_t /* bytes */) {
+void NetworkHandler::Connection::onRead(const boost::system::error_code& ec, std::size_t bytes) {
+    TraceSpan span("network read");
     if(!ec) {
-        std::istream is(&readBuf);
-        std::string msg;
-        std::getline(is, msg);
-        QCoreApplication::postEvent(eventReceiver, new ReadEvent(msg));
-        asio::async_read_until(socket, readBuf, '\n', boost::bind(&NetworkHandler::onRead, this, _1, _2));
+        // A read returns whatever the socket has, which during a burst is
+        // many lines. All complete ones go to the GUI thread in one event.
+        std::vector<std::string> lines;
+        wireBytesIn += bytes;
+        lastReceived = std::chrono::steady_clock::now();
+        if(transport == Transport::deflate) {
+            if(!decompress(rawBuf.data(), bytes, lines))
+                return;
+        } else {
+            framer.commit(bytes);
+            bytesIn += bytes;
+            if(transport == Transport::negotiating && !negotiate(lines))
+                return;
+        }
+        framer.extract(lines);
+        if(!pendingPings.empty()) {
+            lines.erase(std::remove_if(lines.begin(), lines.end(), [this](const std::string& line){
+                return !line.empty() && line[0] == '#' && handlePong(line, lastReceived);
+            }), lines.end());
+        }
+        if(!lines.empty())
+            deliver(std::move(lines));
+        startRead();
     } else if(ec.value() != asio::error::basic_errors::operation_aborted) {
-        logger.warning("Could not read data from lobby server: ", ec.message());
+        connectFailed("Lost connection to lobby server: " + ec.message());
     }
 }
 
-void NetworkHandler::send(std::string msg) {
+// Tokenizing happens here rather than in JS. A finished login batch gets an
+// event of its own, in between the commands before and after it. Parse time
+// per command covers tokenizing and updating the mirrored state.
+void NetworkHandler::Connection::deliver(std::vector<std::string>&& lines) {
+    if(capture.isOpen()) {
+        for(auto& line : lines)
+            capture.record(false, line);
+    }
+    profiler->count(ProtocolProfiler::in, lines);
+    if(!tokenizer && !state) {
+        post(new ReadEvent(name, std::move(lines)));
+        return;
+    }
+    std::vector<LobbyCommand> commands;
+    if(tokenizer)
+        commands.reserve(lines.size());
+    ProtocolProfiler::Timings timings;
+    timings.reserve(lines.size());
+    for(auto& line : lines) {
+        auto start = std::chrono::steady_clock::now();
+        LobbyCommand cmd;
+        LobbyTokenizer::tokenize(line, cmd);
+        if(state)
+            state->apply(cmd);
+        timings.push_back(std::make_pair(cmd.command, std::chrono::steady_clock::now() - start));
+        if(!tokenizer || !tokenizer->feed(cmd))
+            continue;
+        if(auto batch = tokenizer->takeBatch()) {
+            if(!commands.empty())
+                post(new ReadEvent(name, std::move(commands)));
+            commands.clear();
+            logger.info(tag, "Login burst of ", batch->lines, " lines batched");
+            post(new ReadEvent(name, std::move(batch)));
+        }
+        commands.push_back(std::move(cmd));
+    }
+    profiler->addParseTimes(timings);
+    if(!tokenizer)
+        post(new ReadEvent(name, std::move(lines)));
+    else if(!commands.empty())
+        post(new ReadEvent(name, std::move(commands)));
+    if(state)
+        scheduleDiff();
+}
+
+// Protocol lines are never dropped, JS would lose track of the lobby.
+void NetworkHandler::Connection::post(ReadEvent* evt) {
+    evt->profiler = profiler;
+    EventScheduler::post(eventReceiver, evt, false);
+}
+
+void NetworkHandler::Connection::logProfile() {
+    std::string summary = profiler->summary(10);
+    if(!summary.empty())
+        logger.info(tag, "Protocol traffic by command (messages/bytes): ", summary);
+}
+
+// Changes are collected for stateDiffInterval ms and go out as one diff.
+// Diffs are never dropped, JS would be left with a stale copy.
+void NetworkHandler::Connection::scheduleDiff() {
+    if(diffPending || !options.stateDiffInterval || !state->hasChanges())
+        return;
+    diffPending = true;
+    std::shared_ptr<LobbyState> st = state;
+    diffTimer.expires_from_now(std::chrono::milliseconds(options.stateDiffInterval));
+    diffTimer.async_wait(track([this, st](const boost::system::error_code& ec){
+        if(ec)
+            return;
+        diffPending = false;
+        LobbyState::Diff diff = st->takeDiff();
+        if(!diff.empty())
+            EventScheduler::post(eventReceiver, new StateDiffEvent(name, std::move(diff)), false);
+    }));
+}
+
+// Lines are taken one at a time, whatever follows the server's answer may
+// already be compressed.
+bool NetworkHandler::Connection::negotiate(std::vector<std::string>& lines) {
+    while(transport == Transport::negotiating && framer.extract(lines, 1) > 0) {
+        std::string& line = lines.back();
+        if(line.compare(0, 9, "TASServer") == 0)
+            continue;
+        if(line == "COMPRESSOK deflate" || line == "COMPRESSOK deflate\r") {
+            lines.pop_back();
+            std::string rest;
+            framer.drain(rest);
+            bytesIn -= rest.size();
+            endNegotiation(true);
+            return decompress(rest.data(), rest.size(), lines);
+        }
+        logger.info(tag, "Lobby server doesn't support compression, continuing uncompressed");
+        endNegotiation(false);
+    }
+    return true;
+}
+
+// Inflates into the framer, a corrupt stream fails the connection like a
+// lost one.
+bool NetworkHandler::Connection::decompress(const char* data, std::size_t len, std::vector<std::string>& lines) {
+    unsigned long before = zstream.decompressed();
+    if(!zstream.decompress(data, len, framer, lines)) {
+        connectFailed("Could not decompress data from lobby server: " + zstream.error());
+        return false;
+    }
+    bytesIn += zstream.decompressed() - before;
+    return true;
+}
+
+void NetworkHandler::Connection::endNegotiation(bool compress) {
+    transport = compress ? Transport::deflate : Transport::plain;
+    compressed = compress;
+    negotiateTimer.cancel();
+    scheduleWrite();
+}
+
+void NetworkHandler::Connection::send(std::string&& msg) {
+    if(!socket.is_open()) {
+        logger.warning(tag, "Could not send data to lobby server: not connected");
+        return;
+    }
+    std::size_t begin = 0, end;
+    while((end = msg.find('\n', begin)) != std::string::npos) {
+        std::string line = msg.substr(begin, end - begin);
+        if(capture.isOpen())
+            capture.record(true, line);
+        profiler->count(ProtocolProfiler::out, line);
+        begin = end + 1;
+    }
+    if(begin < msg.size()) {
+        std::string line = msg.substr(begin);
+        if(capture.isOpen())
+            capture.record(true, line);
+        profiler->count(ProtocolProfiler::out, line);
+    }
+    queuedMessages++;
+    queuedBytes += msg.size();
+    sendQueue.push_back(std::move(msg));
+    scheduleWrite();
+}
+
+void NetworkHandler::Connection::setPacing(unsigned int rate, unsigned int burst) {
+    this->rate = rate;
+    this->burst = std::max(burst, 1u);
+    tokens = std::min(tokens, this->burst);
+    pacingTimer.cancel();
+    scheduleWrite();
+}
+
+NetworkHandler::SendStats NetworkHandler::Connection::sendStats() const {
+    return SendStats { queuedMessages, queuedBytes, inFlightBytes, sentMessages, sentBytes, pacedWaits };
+}
+
+NetworkHandler::TransportStats NetworkHandler::Connection::transportStats() const {
+    return TransportStats { compressed, bytesIn, wireBytesIn, sentBytes, wireBytesOut };
+}
+
+NetworkHandler::ConnectStats NetworkHandler::Connection::connectStats() const {
+    boost::lock_guard<boost::mutex> lock(statsMutex);
+    return ConnectStats { connects, connectFailures, reconnects, lastConnectUs, lastResolveUs,
+        lastEndpointsTried, lastFromCache, lastEndpoint };
+}
+
+// Chat and pings, everything else (status updates, script tags, joins...)
+// is bulk traffic that may wait.
+bool NetworkHandler::Connection::isInteractive(const std::string& msg) {
+    std::size_t start = 0;
+    if(!msg.empty() && msg[0] == '#') {
+        start = msg.find(' ');
+        if(start == std::string::npos)
+            return false;
+        start++;
+    }
+    return msg.compare(start, 3, "SAY") == 0 || msg.compare(start, 4, "PING") == 0;
+}
+
+// Gathers as many queued messages as the bucket allows into one write, in
+// the order they were sent. Bulk messages have to leave a quarter of the
+// bucket, chat may use it, so chat behind a bulk burst isn't held up by the
+// bucket running dry, but it never overtakes. If nothing may go out yet,
+// the pacing timer retries once enough tokens have accumulated. A message
+// bigger than the bucket goes out alone once the bucket is full.
+void NetworkHandler::Connection::scheduleWrite() {
+    if(writeInProgress || pacingWait || transport == Transport::negotiating || !socket.is_open())
+        return;
+    const std::size_t maxGather = 64;
+    std::size_t bytes = 0;
+    if(rate > 0) {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+        tokens = std::min(burst, tokens + elapsed * rate);
+        lastRefill = now;
+    }
+    auto reserve = [&](const std::string& msg) { return isInteractive(msg) ? 0 : burst / 4; };
+    while(!sendQueue.empty() && writing.size() < maxGather) {
+        std::size_t len = sendQueue.front().size();
+        if(rate > 0 && tokens - bytes - len < reserve(sendQueue.front()) && !(writing.empty() && tokens >= burst))
+            break;
+        bytes += len;
+        writing.push_back(std::move(sendQueue.front()));
+        sendQueue.pop_front();
+    }
+
+    if(writing.empty()) {
+        if(sendQueue.empty())
+            return;
+        double needed = sendQueue.front().size() + reserve(sendQueue.front());
+        double wait = (std::min(needed, burst) - tokens) / rate;
+        pacedWaits++;
+        pacingWait = true;
+        pacingTimer.expires_from_now(std::chrono::microseconds(std::max(1000ll, (long long)(wait * 1e6))));
+        pacingTimer.async_wait(track([this](const boost::system::error_code&){
+            pacingWait = false;
+            scheduleWrite();
+        }));
+        return;
+    }
+
+    if(rate > 0)
+        tokens -= bytes;
+    // Buffers are taken only now, moving the strings may move short ones' data.
+    writeBufs.clear();
+    if(transport == Transport::deflate) {
+        deflated.clear();
+        for(std::size_t i = 0; i < writing.size(); i++)
+            zstream.compress(writing[i].data(), writing[i].size(), i + 1 == writing.size(), deflated);
+        writeBufs.push_back(asio::buffer(deflated));
+    } else {
+        for(auto& msg : writing)
+            writeBufs.push_back(asio::buffer(msg));
+    }
+    queuedMessages -= writing.size();
+    queuedBytes -= bytes;
+    inFlightBytes = bytes;
+    writeInProgress = true;
+    asio::async_write(socket, writeBufs, track(boost::bind(&NetworkHandler::Connection::onWrite, this, _1, _2)));
+}
+
+// Called in the network thread.
+void NetworkHandler::Connection::onWrite(const boost::system::error_code& ec, std::size_t bytes) {
+    writeInProgress = false;
+    inFlightBytes = 0;
+    if(ec) {
+        if(ec != asio::error::operation_aborted)
+            logger.warning(tag, "Could not send data to lobby server: ", ec.message());
+        writing.clear();
+        clearSendQueue();
+        return;
+    }
+    sentMessages += writing.size();
+    for(auto& msg : writing)
+        sentBytes += msg.size();
+    wireBytesOut += bytes;
+    writing.clear();
+    scheduleWrite();
+}
+
+void NetworkHandler::Connection::clearSendQueue() {
+    sendQueue.clear();
+    queuedMessages = 0;
+    queuedBytes = 0;
+    pacingTimer.cancel();
+}
+
+void NetworkHandler::Connection::disconnect() {
+    generation++;
+    active = false;
+    if(socket.is_open()) {
+        logger.info(tag, "Disconnecting from lobby server.");
+        socket.close();
+        logProfile();
+    }
+    closeAttempts();
+    resolver.cancel();
+    reconnectTimer.cancel();
+    negotiateTimer.cancel();
+    pingTimer.cancel();
+    diffTimer.cancel();
+    diffPending = false;
+    replayTimer.cancel();
+    replayRecords.reset();
+    clearSendQueue();
+}
+
+void NetworkHandler::Connection::whenDrained(std::function<void()> drained) {
+    if(pendingHandlers == 0)
+        drained();
+    else
+        this->drained = std::move(drained);
+}
+
+void NetworkHandler::Connection::untrack() {
+    if(--pendingHandlers == 0 && drained) {
+        auto f = std::move(drained);
+        drained = nullptr;
+        f();
+    }
+}
+
+void NetworkHandler::Connection::startCapture(const boost::filesystem::path& path) {
+    if(capture.open(path))
+        logger.info(tag, "Capturing lobby traffic to ", path);
+    else
+        logger.error(tag, "Could not open capture file ", path);
+}
+
+void NetworkHandler::Connection::stopCapture() {
+    if(!capture.isOpen())
+        return;
+    logger.info(tag, "Captured ", capture.lines(), " lines to ", capture.path());
+    capture.close();
+}
+
+void NetworkHandler::Connection::replay(const boost::filesystem::path& path, ConnectOptions options, double speed) {
+    disconnect();
+    auto records = std::make_shared<std::vector<CaptureRecord>>();
+    std::string error;
+    if(!readCapture(path, *records, error)) {
+        logger.error(tag, "Could not replay ", path, ": ", error);
+        EventScheduler::post(eventReceiver, new ReplayDoneEvent(name, ReplayStats(), error), false);
+        return;
+    }
+    logger.info(tag, "Replaying ", records->size(), " lines from ", path);
+    setOptions(options);
+    if(tokenizer)
+        tokenizer->reset();
+    if(state)
+        state->clear();
+    active = true;
+    replayRecords = records;
+    replayPos = 0;
+    replaySpeed = speed;
+    replayLines = replayBytes = 0;
+    replayStart = std::chrono::steady_clock::now();
+    replayStep(generation);
+}
+
+// Lines are handed over in chunks of about what a socket read returns. In
+// real time a chunk is whatever is due, as fast as possible the next chunk
+// is posted behind whatever else the network thread has to do.
+void NetworkHandler::Connection::replayStep(unsigned int gen) {
+    static const std::size_t chunkBytes = 65536;
+    if(gen != generation || !replayRecords)
+        return;
+    const std::vector<CaptureRecord>& records = *replayRecords;
+    auto now = std::chrono::steady_clock::now();
+    long long due = std::chrono::duration_cast<std::chrono::microseconds>(now - replayStart).count() * replaySpeed;
+    std::vector<std::string> lines;
+    std::size_t bytes = 0;
+    for(; replayPos < records.size() && bytes < chunkBytes; replayPos++) {
+        const CaptureRecord& record = records[replayPos];
+        if(replaySpeed > 0 && record.timeUs > due)
+            break;
+        if(record.sent)
+            continue;
+        bytes += record.line.size() + 1;
+        lines.push_back(record.line);
+    }
+    replayLines += lines.size();
+    replayBytes += bytes;
+    lastReceived = now;
+    if(!lines.empty())
+        deliver(std::move(lines));
+
+    if(replayPos < records.size()) {
+        if(replaySpeed > 0 && bytes < chunkBytes) {
+            long long wait = (records[replayPos].timeUs - due) / replaySpeed;
+            replayTimer.expires_from_now(std::chrono::microseconds(std::max(wait, 0LL)));
+            replayTimer.async_wait(track([this, gen](const boost::system::error_code& ec){
+                if(!ec)
+                    replayStep(gen);
+            }));
+        } else {
+            service.post(track([this, gen]{ replayStep(gen); }));
+        }
+        return;
+    }
+    ReplayStats stats;
+    stats.lines = replayLines;
+    stats.bytes = replayBytes;
+    stats.feedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - replayStart).count();
+    logger.info(tag, "Replayed ", replayLines, " lines in ", stats.feedUs / 1000, " ms");
+    replayRecords.reset();
+    active = false;
+    EventScheduler::post(eventReceiver, new ReplayDoneEvent(name, stats, ""), false);
+}
+
+std::shared_ptr<LobbyState> NetworkHandler::Connection::lobbyState() const {
+    boost::lock_guard<boost::mutex> lock(statsMutex);
+    return state;
+}
+
+std::shared_ptr<NetworkHandler::Connection> NetworkHandler::find(const std::string& name) const {
+    boost::lock_guard<boost::mutex> lock(connectionsMutex);
+    auto it = connections.find(name);
+    return it == connections.end() ? std::shared_ptr<Connection>() : it->second;
+}
+
+// Called in the network thread.
+std::shared_ptr<NetworkHandler::Connection> NetworkHandler::obtain(const std::string& name) {
+    std::shared_ptr<Connection> conn = find(name);
+    if(!conn) {
+        Connection::Settings settings = { pacingRate, pacingBurst, pingInterval, stallWindow };
+        conn = std::make_shared<Connection>(service, name, endpointCache, settings, eventReceiver, logger);
+        boost::lock_guard<boost::mutex> lock(connectionsMutex);
+        connections[name] = conn;
+    }
+    return conn;
+}
+
+// Called in the network thread. The connection is gone from the map right
+// away but is kept in retired until its cancelled handlers have run. It's
+// destroyed from a handler of its own, outside of its code.
+void NetworkHandler::retire(std::shared_ptr<Connection> conn) {
+    conn->disconnect();
+    Connection* key = conn.get();
+    retired[key] = conn;
+    conn->whenDrained([this, key]{
+        service.post([this, key]{ retired.erase(key); });
+    });
+}
+
+void NetworkHandler::connect(const std::string& name, std::string host, unsigned int port, ConnectOptions options) {
     service.post([=]{
-        try {
-            asio::write(socket, boost::asio::buffer(msg));
-        } catch(boost::system::system_error e) {
-            logger.warning("Could not send data to lobby server: ", e.what());
+        obtain(name)->connect(host, port, options);
+    });
+}
+
+void NetworkHandler::startCapture(const std::string& name, const boost::filesystem::path& path) {
+    service.post([=]{
+        obtain(name)->startCapture(path);
+    });
+}
+
+void NetworkHandler::stopCapture(const std::string& name) {
+    service.post([=]{
+        if(auto conn = find(name))
+            conn->stopCapture();
+    });
+}
+
+void NetworkHandler::replay(const std::string& name, const boost::filesystem::path& path, ConnectOptions options,
+        double speed) {
+    service.post([=]{
+        obtain(name)->replay(path, options, speed);
+    });
+}
+
+void NetworkHandler::probe(unsigned int id, std::vector<UdpProber::Target> targets, UdpProber::Options options) {
+    service.post([=]{
+        prober.probe(id, targets, options, [this](unsigned int id, std::vector<UdpProber::Result>&& results, bool done){
+            EventScheduler::post(eventReceiver, new ProbeEvent(id, std::move(results), done), false);
+        });
+    });
+}
+
+void NetworkHandler::disconnect(const std::string& name) {
+    service.post([=]{
+        std::shared_ptr<Connection> conn;
+        {
+            boost::lock_guard<boost::mutex> lock(connectionsMutex);
+            auto it = connections.find(name);
+            if(it == connections.end())
+                return;
+            conn = std::move(it->second);
+            connections.erase(it);
         }
+        retire(std::move(conn));
     });
 }
 
-void NetworkHandler::disconnect() {
+void NetworkHandler::disconnectAll() {
     service.post([=]{
-        if(socket.is_open()) {
-            logger.info("Disconnecting from lobby server.");
-            socket.close();
+        std::map<std::string, std::shared_ptr<Connection>> all;
+        {
+            boost::lock_guard<boost::mutex> lock(connectionsMutex);
+            all.swap(connections);
         }
+        for(auto& conn : all)
+            retire(std::move(conn.second));
+    });
+}
+
+void NetworkHandler::send(const std::string& name, std::string msg) {
+    service.post([=]() mutable {
+        if(auto conn = find(name))
+            conn->send(std::move(msg));
+        else
+            logger.warning(name.empty() ? "" : "[" + name + "] ", "Could not send data to lobby server: not connected");
     });
 }
 
+void NetworkHandler::setPacing(unsigned int rate, unsigned int burst) {
+    service.post([=]{
+        pacingRate = rate;
+        pacingBurst = burst;
+        for(auto& conn : connections)
+            conn.second->setPacing(rate, burst);
+    });
+}
+
+void NetworkHandler::setLinkMonitor(unsigned int interval, unsigned int stallWindow) {
+    service.post([=]{
+        pingInterval = interval;
+        this->stallWindow = stallWindow;
+        for(auto& conn : connections)
+            conn.second->setLinkMonitor(interval, stallWindow);
+    });
+}
+
+void NetworkHandler::setCachePath(const boost::filesystem::path& path) {
+    service.post([=]{ endpointCache.load(path); });
+}
+
+std::vector<std::string> NetworkHandler::connectionNames() const {
+    std::vector<std::string> names;
+    boost::lock_guard<boost::mutex> lock(connectionsMutex);
+    for(auto& conn : connections) {
+        if(conn.second->isActive())
+            names.push_back(conn.first);
+    }
+    return names;
+}
+
+NetworkHandler::SendStats NetworkHandler::sendStats(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->sendStats() : SendStats();
+}
+
+NetworkHandler::TransportStats NetworkHandler::transportStats(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->transportStats() : TransportStats();
+}
+
+NetworkHandler::ConnectStats NetworkHandler::connectStats(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->connectStats() : ConnectStats();
+}
+
+NetworkHandler::LinkStats NetworkHandler::linkStats(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->linkStats() : LinkStats();
+}
+
+std::shared_ptr<const LobbyState> NetworkHandler::lobbyState(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->lobbyState() : std::shared_ptr<const LobbyState>();
+}
+
+std::shared_ptr<const ProtocolProfiler> NetworkHandler::protocolProfiler(const std::string& name) const {
+    auto conn = find(name);
+    return conn ? conn->protocolProfiler() : std::shared_ptr<const ProtocolProfiler>();
+}
+
 void NetworkHandler::runService() {
+    Trace::setThreadName("network");
     service.run();
 }
 
-NetworkHandler::NetworkHandler(QObject* eventReceiver, Logger& logger) : resolver(service), socket(service),
-        eventReceiver(eventReceiver), logger(logger) {
+// Pacing and the link monitor are off until JS turns them on, the burst is
+// about a hundred lines.
+NetworkHandler::NetworkHandler(QObject* eventReceiver, Logger& logger) : pacingRate(0), pacingBurst(16384),
+        pingInterval(0), stallWindow(30000), prober(service, logger), eventReceiver(eventReceiver),
+        logger(logger) {
     work = new asio::io_service::work(service);
     thread = boost::thread(boost::bind(&NetworkHandler::runService, this));
 }
 
+// Connections go before the io_service they were created with.
 NetworkHandler::~NetworkHandler() {
+    service.post([this]{ prober.cancelAll(); });
     delete work;
     thread.join();
+    connections.clear();
+    retired.clear();
 }
@@ -0,0 +1,147 @@
+#include "perfstats.h"
+#include "nativeevent.h"
+#include <QEvent>
+#include <algorithm>
+#include <cstdio>
+
+const long long PerfStats::Histogram::bounds[bucketCount - 1] = {
+    10, 25, 50, 100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000,
+    100000, 250000, 500000, 1000000, 2500000
+};
+
+PerfStats::Histogram::Histogram() : buckets(), count(0), sumUs(0), maxUs(0) {}
+
+void PerfStats::Histogram::add(clock::duration d) {
+    long long us = std::max<long long>(0, std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    int i = std::lower_bound(bounds, bounds + bucketCount - 1, us) - bounds;
+    buckets[i]++;
+    count++;
+    sumUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+// Quantiles are reported as the upper bound of the bucket they fall into.
+QVariantMap PerfStats::Histogram::toVariant() const {
+    QVariantMap res;
+    res["count"] = count;
+    res["meanUs"] = count ? double(sumUs) / count : 0.0;
+    res["maxUs"] = maxUs;
+    for (auto q : { std::make_pair("p50Us", 0.5), std::make_pair("p99Us", 0.99) }) {
+        unsigned long long seen = 0;
+        long long bound = 0;
+        for (int i = 0; i < bucketCount && count; i++) {
+            seen += buckets[i];
+            if (seen >= q.second * count) {
+                bound = i < bucketCount - 1 ? bounds[i] : maxUs;
+                break;
+            }
+        }
+        res[q.first] = bound;
+    }
+    return res;
+}
+
+void PerfStats::Histogram::toPrometheus(std::string& out, const std::string& name, const std::string& labels) const {
+    char buf[64];
+    std::string sep = labels.empty() ? "" : ",";
+    unsigned long long cumulative = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        cumulative += buckets[i];
+        if (i < bucketCount - 1)
+            std::snprintf(buf, sizeof(buf), "%g", bounds[i] / 1e6);
+        out += name + "_bucket{" + labels + sep + "le=\"" + (i < bucketCount - 1 ? buf : "+Inf") + "\"} " +
+            std::to_string(cumulative) + "\n";
+    }
+    std::snprintf(buf, sizeof(buf), "%.6f", sumUs / 1e6);
+    out += name + "_sum" + (labels.empty() ? "" : "{" + labels + "}") + " " + buf + "\n";
+    out += name + "_count" + (labels.empty() ? "" : "{" + labels + "}") + " " + std::to_string(count) + "\n";
+}
+
+void PerfStats::recordEvent(int type, const char* name, clock::time_point postTime,
+        clock::time_point start, clock::time_point end) {
+    int i = type - QEvent::User;
+    if (i < 0 || i >= maxEventTypes)
+        return;
+    events[i].name = name;
+    events[i].queueWait.add(start - postTime);
+    events[i].dispatch.add(end - start);
+}
+
+void PerfStats::recordJsCall(int items, clock::duration d) {
+    jsCalls.add(d);
+    jsItems += items;
+}
+
+QVariantMap PerfStats::toVariant() const {
+    QVariantMap res, evts;
+    for (auto& e : events) {
+        if (!e.name)
+            continue;
+        QVariantMap series;
+        series["queueWait"] = e.queueWait.toVariant();
+        series["dispatch"] = e.dispatch.toVariant();
+        evts[e.name] = series;
+    }
+    res["events"] = evts;
+    QVariantMap js = jsCalls.toVariant();
+    js["items"] = jsItems;
+    res["jsCalls"] = js;
+    res["queues"] = queueStats();
+    return res;
+}
+
+QVariantMap PerfStats::queueStats() {
+    QVariantMap queues;
+    for (int i = 0; i < eventClassCount; i++) {
+        auto stats = EventScheduler::stats(EventClass(i));
+        QVariantMap cls;
+        cls["posted"] = stats.posted;
+        cls["dropped"] = stats.dropped;
+        cls["coalesced"] = stats.coalesced;
+        cls["pending"] = stats.pending;
+        cls["limit"] = stats.limit;
+        queues[EventScheduler::className(EventClass(i))] = cls;
+    }
+    return queues;
+}
+
+std::string PerfStats::toPrometheus() const {
+    std::string out;
+    out += "# HELP weblobby_event_queue_wait_seconds Time between posting a native event and its handling in the GUI thread.\n"
+        "# TYPE weblobby_event_queue_wait_seconds histogram\n";
+    for (auto& e : events) {
+        if (e.name)
+            e.queueWait.toPrometheus(out, "weblobby_event_queue_wait_seconds", std::string("type=\"") + e.name + "\"");
+    }
+    out += "# HELP weblobby_event_dispatch_seconds Time spent handling a native event in the GUI thread.\n"
+        "# TYPE weblobby_event_dispatch_seconds histogram\n";
+    for (auto& e : events) {
+        if (e.name)
+            e.dispatch.toPrometheus(out, "weblobby_event_dispatch_seconds", std::string("type=\"") + e.name + "\"");
+    }
+    out += "# HELP weblobby_js_call_seconds Duration of calls into JS delivering a batch of events.\n"
+        "# TYPE weblobby_js_call_seconds histogram\n";
+    jsCalls.toPrometheus(out, "weblobby_js_call_seconds", "");
+    out += "# HELP weblobby_js_call_items_total Native events delivered to JS.\n"
+        "# TYPE weblobby_js_call_items_total counter\n"
+        "weblobby_js_call_items_total " + std::to_string(jsItems) + "\n";
+
+    const char* metrics[][2] = {
+        { "weblobby_event_queue_pending", "gauge" },
+        { "weblobby_events_posted_total", "counter" },
+        { "weblobby_events_dropped_total", "counter" },
+        { "weblobby_events_coalesced_total", "counter" },
+    };
+    for (int m = 0; m < 4; m++) {
+        out += std::string("# TYPE ") + metrics[m][0] + " " + metrics[m][1] + "\n";
+        for (int i = 0; i < eventClassCount; i++) {
+            auto stats = EventScheduler::stats(EventClass(i));
+            unsigned long long val = m == 0 ? stats.pending : m == 1 ? stats.posted :
+                m == 2 ? stats.dropped : stats.coalesced;
+            out += std::string(metrics[m][0]) + "{class=\"" + EventScheduler::className(EventClass(i)) + "\"} " +
+                std::to_string(val) + "\n";
+        }
+    }
+    return out;
+}
@@ -0,0 +1,57 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+// Latency instrumentation of the native -> JS event path. Everything here is
+// only touched by the GUI thread, the post timestamp is taken by
+// EventScheduler::post() in whatever thread the event comes from.
+
+#include <QVariantMap>
+#include <chrono>
+#include <string>
+
+class PerfStats {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    class Histogram {
+    public:
+        Histogram();
+        void add(clock::duration);
+        QVariantMap toVariant() const;
+        // Appends _bucket/_sum/_count lines of a Prometheus histogram.
+        void toPrometheus(std::string& out, const std::string& name, const std::string& labels) const;
+
+        // Upper bounds in microseconds, the last bucket is +Inf.
+        static const int bucketCount = 18;
+        static const long long bounds[bucketCount - 1];
+    private:
+        unsigned long long buckets[bucketCount];
+        unsigned long long count;
+        long long sumUs, maxUs;
+    };
+
+    // Records an event of the given type that was posted at postTime,
+    // whose handling started at start and finished at end.
+    void recordEvent(int type, const char* name, clock::time_point postTime,
+        clock::time_point start, clock::time_point end);
+    // Records a call into JS carrying items native events.
+    void recordJsCall(int items, clock::duration);
+
+    QVariantMap toVariant() const;
+    std::string toPrometheus() const;
+    // EventScheduler counters per event class.
+    static QVariantMap queueStats();
+private:
+    struct EventSeries {
+        EventSeries() : name(NULL) {}
+        const char* name;
+        Histogram queueWait, dispatch;
+    };
+    // Indexed by event type - QEvent::User.
+    static const int maxEventTypes = 16;
+    EventSeries events[maxEventTypes];
+    Histogram jsCalls;
+    unsigned long long jsItems = 0;
+};
+
+#endif // PERFSTATS_H
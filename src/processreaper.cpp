@@ -0,0 +1,245 @@
+#include "processreaper.h"
+#include "trace.h"
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <exception>
+#include <future>
+#if defined BOOST_POSIX_API
+    #include <cerrno>
+    #include <csignal>
+    #include <cstring>
+    #include <fstream>
+    #include <string>
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #ifdef __linux__
+        #include <sys/syscall.h>
+    #endif
+#elif defined BOOST_WINDOWS_API
+    #include <boost/asio/windows/object_handle.hpp>
+    #include <psapi.h>
+#endif
+
+namespace asio = boost::asio;
+
+struct ProcessReaper::Watch {
+    typedef std::chrono::steady_clock clock;
+    Watch(asio::io_service& service, Handle process, ExitHandler handler) : process(process),
+        handler(std::move(handler)), start(clock::now()), sampleTimer(service), done(false) {}
+    Handle process;
+    ExitHandler handler;
+    clock::time_point start;
+    Usage usage;
+    asio::steady_timer sampleTimer;
+    bool done;
+};
+
+// How often the I/O counters of running processes are read, in ms.
+static const unsigned int ioSampleInterval = 2000;
+
+ProcessReaper::ProcessReaper(Logger& logger) : logger(logger), work(new asio::io_service::work(ioService)) {
+    thread = boost::thread([this]{ run(); });
+}
+
+// Processes still running are left alone, their pipes are closed with the
+// service.
+ProcessReaper::~ProcessReaper() {
+    work.reset();
+    ioService.stop();
+    thread.join();
+}
+
+void ProcessReaper::run() {
+    Trace::setThreadName("process io");
+    ioService.run();
+}
+
+void ProcessReaper::execute(std::function<void()> f) {
+    std::promise<void> done;
+    ioService.post([&]{
+        try {
+            f();
+            done.set_value();
+        } catch(...) {
+            done.set_exception(std::current_exception());
+        }
+    });
+    done.get_future().get();
+}
+
+#if defined BOOST_POSIX_API
+
+// Reads the I/O counters of a running or exited but not yet reaped process.
+static bool readProcIo(pid_t pid, ProcessReaper::Usage& usage) {
+#ifdef __linux__
+    std::ifstream in("/proc/" + std::to_string(pid) + "/io");
+    std::string key;
+    long long value;
+    bool any = false;
+    while (in >> key >> value) {
+        if (key == "rchar:")
+            usage.readBytes = value;
+        else if (key == "wchar:")
+            usage.writeBytes = value;
+        else if (key == "read_bytes:")
+            usage.diskReadBytes = value;
+        else if (key == "write_bytes:")
+            usage.diskWriteBytes = value;
+        else
+            continue;
+        any = true;
+    }
+    return any;
+#else
+    (void)pid;
+    (void)usage;
+    return false;
+#endif
+}
+
+static long long timevalUs(const timeval& tv) {
+    return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+void ProcessReaper::watch(pid_t pid, ExitHandler handler) {
+    auto w = std::make_shared<Watch>(ioService, pid, std::move(handler));
+    sampleIo(w);
+    if (watchPidfd(w))
+        return;
+    signalled[pid] = w;
+    if (!sigchld) {
+        sigchld.reset(new asio::signal_set(ioService, SIGCHLD));
+        waitSignal();
+    }
+    // It may have exited before there was anyone to catch the signal.
+    reapSignalled();
+}
+
+// A pidfd becomes readable once its process has exited.
+bool ProcessReaper::watchPidfd(const std::shared_ptr<Watch>& w) {
+#if defined __linux__ && defined SYS_pidfd_open
+    int fd = ::syscall(SYS_pidfd_open, w->process, 0);
+    if (fd < 0)
+        return false;
+    auto pidfd = std::make_shared<asio::posix::stream_descriptor>(ioService, fd);
+    pidfd->async_read_some(asio::null_buffers(), [this, w, pidfd](const boost::system::error_code& ec, std::size_t){
+        if (ec != asio::error::operation_aborted)
+            reap(*w);
+    });
+    return true;
+#else
+    (void)w;
+    return false;
+#endif
+}
+
+void ProcessReaper::sampleIo(const std::shared_ptr<Watch>& w) {
+    w->sampleTimer.expires_from_now(std::chrono::milliseconds(ioSampleInterval));
+    w->sampleTimer.async_wait([this, w](const boost::system::error_code& ec){
+        if (ec || w->done)
+            return;
+        readProcIo(w->process, w->usage);
+        sampleIo(w);
+    });
+}
+
+// Only called once the child has exited, the last I/O sample is taken while
+// it's a zombie.
+void ProcessReaper::reap(Watch& w) {
+    readProcIo(w.process, w.usage);
+    int status = 0;
+    rusage ru;
+    pid_t ret;
+    while ((ret = ::wait4(w.process, &status, 0, &ru)) == -1 && errno == EINTR);
+    Usage& usage = w.usage;
+    usage.wallUs = std::chrono::duration_cast<std::chrono::microseconds>(Watch::clock::now() - w.start).count();
+    if (ret == -1) {
+        logger.warning("wait4(", w.process, ") failed: ", std::strerror(errno));
+        status = -1;
+    } else {
+        usage.userUs = timevalUs(ru.ru_utime);
+        usage.systemUs = timevalUs(ru.ru_stime);
+        #ifdef __APPLE__
+            usage.maxRssKb = ru.ru_maxrss / 1024;
+        #else
+            usage.maxRssKb = ru.ru_maxrss;
+        #endif
+        usage.majorFaults = ru.ru_majflt;
+    }
+    w.done = true;
+    w.sampleTimer.cancel();
+    w.handler(status, usage);
+}
+
+void ProcessReaper::waitSignal() {
+    sigchld->async_wait([this](const boost::system::error_code& ec, int){
+        if (ec)
+            return;
+        reapSignalled();
+        waitSignal();
+    });
+}
+
+// Signals coalesce, so every child that's waited for is polled, without
+// reaping it so its counters can still be read. Children started by anyone
+// else are none of our business and aren't reaped.
+void ProcessReaper::reapSignalled() {
+    for (auto it = signalled.begin(); it != signalled.end();) {
+        siginfo_t info;
+        info.si_pid = 0;
+        int ret;
+        while ((ret = ::waitid(P_PID, it->first, &info, WEXITED | WNOHANG | WNOWAIT)) == -1 && errno == EINTR);
+        if (ret == 0 && info.si_pid == 0) {
+            ++it;
+            continue;
+        }
+        auto w = it->second;
+        signalled.erase(it++);
+        reap(*w);
+    }
+}
+
+#elif defined BOOST_WINDOWS_API
+
+static long long fileTimeUs(const FILETIME& ft) {
+    return ((static_cast<long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) / 10;
+}
+
+// Windows has no major fault count or storage level I/O per process.
+void ProcessReaper::watch(HANDLE process, ExitHandler handler) {
+    HANDLE dup;
+    if (!DuplicateHandle(GetCurrentProcess(), process, GetCurrentProcess(), &dup, 0, FALSE,
+            DUPLICATE_SAME_ACCESS)) {
+        logger.warning("Could not wait for process, DuplicateHandle() failed: ", GetLastError());
+        return;
+    }
+    auto w = std::make_shared<Watch>(ioService, dup, std::move(handler));
+    auto waiter = std::make_shared<asio::windows::object_handle>(ioService, dup);
+    waiter->async_wait([w, waiter](const boost::system::error_code& ec){
+        if (ec)
+            return;
+        HANDLE h = waiter->native_handle();
+        DWORD code = EXIT_FAILURE;
+        GetExitCodeProcess(h, &code);
+        Usage& usage = w->usage;
+        usage.wallUs = std::chrono::duration_cast<std::chrono::microseconds>(Watch::clock::now() - w->start).count();
+        FILETIME creation, exit, kernel, user;
+        if (GetProcessTimes(h, &creation, &exit, &kernel, &user)) {
+            usage.userUs = fileTimeUs(user);
+            usage.systemUs = fileTimeUs(kernel);
+        }
+        PROCESS_MEMORY_COUNTERS mem;
+        if (GetProcessMemoryInfo(h, &mem, sizeof(mem)))
+            usage.maxRssKb = mem.PeakWorkingSetSize / 1024;
+        IO_COUNTERS io;
+        if (GetProcessIoCounters(h, &io)) {
+            usage.readBytes = io.ReadTransferCount;
+            usage.writeBytes = io.WriteTransferCount;
+        }
+        w->done = true;
+        w->handler(code, usage);
+    });
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef PROCESSREAPER_H
+#define PROCESSREAPER_H
+
+// One thread that starts, reaps and reads the output of every process
+// launched by ProcessRunner, so the number of threads doesn't grow with the
+// number of running commands. On Linux exits are waited for with pidfds,
+// where the kernel has none with SIGCHLD, elsewhere on POSIX with SIGCHLD
+// and on Windows with the process handle. What a process used is collected
+// when it's reaped, its I/O counters on Linux are also sampled while it runs
+// in case they can't be read at the end.
+
+#include "logger.h"
+#include <boost/asio.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/process/config.hpp>
+#include <boost/thread.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#if defined BOOST_POSIX_API
+    #include <sys/types.h>
+#elif defined BOOST_WINDOWS_API
+    #include <windows.h>
+#endif
+
+class ProcessReaper {
+public:
+    #if defined BOOST_POSIX_API
+        typedef pid_t Handle;
+    #elif defined BOOST_WINDOWS_API
+        typedef HANDLE Handle;
+    #endif
+    // Resources used by a process over its lifetime, -1 where the platform
+    // doesn't tell.
+    struct Usage {
+        Usage() : wallUs(0), userUs(-1), systemUs(-1), maxRssKb(-1), majorFaults(-1), readBytes(-1),
+            writeBytes(-1), diskReadBytes(-1), diskWriteBytes(-1) {}
+        // From watch() to the exit.
+        long long wallUs;
+        long long userUs, systemUs;
+        // Peak resident set (working set on Windows).
+        long long maxRssKb;
+        long long majorFaults;
+        // Everything read and written, pipes and sockets included.
+        long long readBytes, writeBytes;
+        // What actually hit the storage layer, only on Linux.
+        long long diskReadBytes, diskWriteBytes;
+    };
+    // Gets the exit status: the wait status on POSIX, as returned by
+    // waitpid(), and the exit code on Windows.
+    typedef std::function<void(int status, const Usage&)> ExitHandler;
+
+    explicit ProcessReaper(Logger&);
+    ~ProcessReaper();
+
+    // Pipe ends of processes are read with this service.
+    boost::asio::io_service& service() { return ioService; }
+
+    // Runs f in the reaper thread and waits for it, rethrowing whatever it
+    // threw. Processes are started this way, Windows only lets the thread
+    // that created a process wait for it. Not to be called from the reaper
+    // thread itself.
+    void execute(std::function<void()> f);
+    // Calls handler in the reaper thread once the process has exited and
+    // been reaped. Only call it in the reaper thread. On Windows the handle
+    // is duplicated, the caller keeps its own.
+    void watch(Handle process, ExitHandler handler);
+private:
+    struct Watch;
+    void run();
+    #ifdef BOOST_POSIX_API
+        bool watchPidfd(const std::shared_ptr<Watch>&);
+        void waitSignal();
+        void reapSignalled();
+        void sampleIo(const std::shared_ptr<Watch>&);
+        void reap(Watch&);
+    #endif
+
+    Logger& logger;
+    boost::asio::io_service ioService;
+    std::unique_ptr<boost::asio::io_service::work> work;
+    #ifdef BOOST_POSIX_API
+        // Only set up once a pidfd couldn't be had, SIGCHLD wakes up
+        // reapSignalled() which polls every pid in signalled.
+        std::unique_ptr<boost::asio::signal_set> sigchld;
+        std::map<pid_t, std::shared_ptr<Watch>> signalled;
+    #endif
+    boost::thread thread;
+};
+
+#endif // PROCESSREAPER_H
@@ -1,9 +1,14 @@
 #include "lobbyinterface.h"
+#include "lineframer.h"
+#include "processspawn.h"
+#include "trace.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <QCoreApplication>
 #include <boost/process/mitigate.hpp>
-#include <boost/chrono/include.hpp>
 #ifdef BOOST_WINDOWS_API
     #include <windows.h>
     #include <ctime>
@@ -13,15 +18,156 @@
 namespace process = boost::process;
 namespace asio = boost::asio;
 
-typedef asio::buffers_iterator<asio::streambuf::const_buffers_type> buf_iterator;
-std::pair<buf_iterator, bool> matchNewline(buf_iterator begin, buf_iterator end) {
-    for(auto i = begin; i != end; i++) {
-        if(*i == '\r' && i + 1 != end && *(++i) == '\n')
-            return std::make_pair(++i, true);
-        else if(*i == '\n' || *i == '\r')
-            return std::make_pair(++i, true);
+// Everything but the constructor is only touched in the reaper thread.
+struct ProcessRunner::State : std::enable_shared_from_this<State> {
+    typedef std::chrono::steady_clock clock;
+    State(asio::io_service& service, QObject* eventReceiver, Logger& logger, const std::string& cmd,
+        const OutputLimits& limits, std::shared_ptr<process::pipe_end> stdoutPend,
+        std::shared_ptr<process::pipe_end> stderrPend) :
+        eventReceiver(eventReceiver), logger(logger), cmd(cmd), limits(limits), stdoutPend(stdoutPend),
+        stderrPend(stderrPend), stdoutFramer(65536, 16 << 20, true), stderrFramer(65536, 16 << 20, true),
+        flushTimer(service), flushPending(false), tokens(limits.burst),
+        lastRefill(clock::now()), suppressed(0), returnCode(0), left(3), detached(false) {}
+    void read(process::pipe_end&, LineFramer&);
+    void admit();
+    void spill(const std::string& line);
+    void announceSuppressed();
+    void scheduleFlush();
+    void flush();
+    // Called once for each pipe at its end and once for the exit.
+    void finished();
+
+    QObject* eventReceiver;
+    Logger& logger;
+    std::string cmd;
+    OutputLimits limits;
+    std::shared_ptr<process::pipe_end> stdoutPend, stderrPend;
+    LineFramer stdoutFramer, stderrFramer;
+    // Lines of the last read, then the ones waiting to be posted.
+    std::vector<std::string> extracted, batch;
+    asio::steady_timer flushTimer;
+    bool flushPending;
+    double tokens;
+    clock::time_point lastRefill;
+    // Lines spilled since the last marker.
+    unsigned long long suppressed;
+    boost::filesystem::path spillPath;
+    std::unique_ptr<uofstream> spillFile;
+    int returnCode;
+    ProcessReaper::Usage usage;
+    int left;
+    // Set once the runner is destroyed.
+    bool detached;
+};
+
+// Reads whatever the pipe has, up to the free space of the framer, and
+// takes all complete lines out at once. What's left of a line at the end of
+// the output is a line too.
+void ProcessRunner::State::read(process::pipe_end& pend, LineFramer& framer) {
+    auto self = shared_from_this();
+    pend.async_read_some(framer.prepare(), [self, &pend, &framer](const boost::system::error_code& ec,
+            std::size_t bytes){
+        TraceSpan span("process read");
+        framer.commit(bytes);
+        framer.extract(self->extracted);
+        if(ec && framer.buffered() > 0) {
+            self->extracted.emplace_back();
+            framer.drain(self->extracted.back());
+        }
+        self->admit();
+        if(ec) {
+            self->finished();
+            return;
+        }
+        self->read(pend, framer);
+    });
+}
+
+// Lines are let through while the token bucket has tokens, the rest is
+// spilled. The marker for spilled lines goes out before the next line that
+// is let through, or with the next batch.
+void ProcessRunner::State::admit() {
+    if(extracted.empty() || detached) {
+        extracted.clear();
+        return;
+    }
+    if(limits.lineRate) {
+        auto now = clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+        tokens = std::min<double>(limits.burst, tokens + elapsed * limits.lineRate);
+        lastRefill = now;
+    }
+    for(auto& line : extracted) {
+        if(limits.lineRate && tokens < 1) {
+            spill(line);
+            continue;
+        }
+        if(limits.lineRate)
+            tokens -= 1;
+        announceSuppressed();
+        batch.push_back(std::move(line));
     }
-    return std::make_pair(end, false);
+    extracted.clear();
+    if(limits.batchInterval == 0)
+        flush();
+    else
+        scheduleFlush();
+}
+
+void ProcessRunner::State::spill(const std::string& line) {
+    suppressed++;
+    if(limits.spillDir.empty())
+        return;
+    if(!spillFile) {
+        spillPath = limits.spillDir / (fileName(cmd) + ".spill.log");
+        spillFile.reset(new uofstream(spillPath));
+        if(!spillFile->good())
+            logger.warning("Could not open the spill file of ", cmd, " in ", limits.spillDir);
+    }
+    *spillFile << line << '\n';
+}
+
+void ProcessRunner::State::announceSuppressed() {
+    if(!suppressed)
+        return;
+    std::string marker = std::to_string(suppressed) + " lines suppressed";
+    if(spillFile && spillFile->good()) {
+        spillFile->flush();
+        marker += ", see " + spillPath.string();
+    }
+    batch.push_back(std::move(marker));
+    suppressed = 0;
+}
+
+void ProcessRunner::State::scheduleFlush() {
+    if(flushPending)
+        return;
+    flushPending = true;
+    auto self = shared_from_this();
+    flushTimer.expires_from_now(std::chrono::milliseconds(limits.batchInterval));
+    flushTimer.async_wait([self](const boost::system::error_code& ec){
+        self->flushPending = false;
+        if(!ec)
+            self->flush();
+    });
+}
+
+void ProcessRunner::State::flush() {
+    announceSuppressed();
+    if(batch.empty() || detached)
+        return;
+    // The token bucket already bounds the rate, whatever it let through
+    // must arrive or the "suppressed" markers would lie.
+    EventScheduler::post(eventReceiver, new ReadEvent(cmd, std::move(batch)), false);
+    batch.clear();
+}
+
+void ProcessRunner::State::finished() {
+    if(--left > 0 || detached)
+        return;
+    flushTimer.cancel();
+    flush();
+    EventScheduler::post(eventReceiver, new TerminateEvent(cmd, returnCode, usage), false);
 }
 
 void ProcessRunner::run() {
@@ -30,11 +176,11 @@ void ProcessRunner::run() {
     #if defined BOOST_POSIX_API
         process::pipe stdout_pipe = process::create_pipe();
         auto stdout_sink = std::make_shared<file_descriptor_sink>(stdout_pipe.sink, close_handle);
-        auto stdout_pend = std::make_shared<process::pipe_end>(service, stdout_pipe.source);
+        auto stdout_pend = std::make_shared<process::pipe_end>(reaper.service(), stdout_pipe.source);
 
         process::pipe stderr_pipe = process::create_pipe();
         auto stderr_sink = std::make_shared<file_descriptor_sink>(stderr_pipe.sink, close_handle);
-        auto stderr_pend = std::make_shared<process::pipe_end>(service, stderr_pipe.source);
+        auto stderr_pend = std::make_shared<process::pipe_end>(reaper.service(), stderr_pipe.source);
     #elif defined BOOST_WINDOWS_API
         static std::minstd_rand rand(std::time(NULL));
         std::wstring pipe_name = L"\\\\.\\pipe\\springweblobby" + std::to_wstring(rand());
@@ -44,14 +190,14 @@ void ProcessRunner::run() {
         HANDLE stdout_pipe_sink = CreateFile((pipe_name + L"stdout").c_str(), GENERIC_WRITE, 0, NULL,
             OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
         auto stdout_sink = std::make_shared<file_descriptor_sink>(stdout_pipe_sink, never_close_handle);
-        auto stdout_pend = std::make_shared<process::pipe_end>(service, stdout_pipe_source);
+        auto stdout_pend = std::make_shared<process::pipe_end>(reaper.service(), stdout_pipe_source);
 
         HANDLE stderr_pipe_source = CreateNamedPipe((pipe_name + L"stderr").c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
             PIPE_TYPE_BYTE | PIPE_REJECT_REMOTE_CLIENTS, 1, 1024*32, 1024*32, 0, NULL);
         HANDLE stderr_pipe_sink = CreateFile((pipe_name + L"stderr").c_str(), GENERIC_WRITE, 0, NULL,
             OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
         auto stderr_sink = std::make_shared<file_descriptor_sink>(stderr_pipe_sink, never_close_handle);
-        auto stderr_pend = std::make_shared<process::pipe_end>(service, stderr_pipe_source);
+        auto stderr_pend = std::make_shared<process::pipe_end>(reaper.service(), stderr_pipe_source);
     #endif
 
     std::vector<std::string> env;
@@ -147,121 +293,95 @@ void ProcessRunner::run() {
             sargs.push_back(toStdString(i));
     #endif
 
-    try {
-        auto e_ptr = std::make_shared<std::exception_ptr>();
-        waitForExitThread = boost::thread([=](){
-            try {
-                auto child = process::execute(
-                    #if defined BOOST_POSIX_API
-                        set_args(sargs),
-                        set_env(env),
-                    #elif defined BOOST_WINDOWS_API
-                        set_args(args),
-                        set_env(wenv),
-                    #endif
-                    bind_stdout(*stdout_sink),
-                    bind_stderr(*stderr_sink),
-                    close_stdin(),
-                    #ifdef BOOST_POSIX_API
-                        notify_io_service(service),
-                    #endif
-                    hide_console(),
-                    throw_on_error()
-                );
-                #if defined BOOST_POSIX_API
-                    terminate_func = [child]() { boost::system::error_code ec; process::terminate(child, ec); };
-                #elif defined BOOST_WINDOWS_API
-                    HANDLE native_handle = child.process_handle();
-                    terminate_func = [native_handle]() { TerminateProcess(native_handle, EXIT_FAILURE); };
-                #endif
-
-                // Now who would have guessed that calling WaitForSingleObject() on a process
-                // in a thread other than the thread where you created the process doesn't work?
-                // Certainly not MSDN docs, that's for sure. No mention of that there.
-                // Man I hate WinAPI.
-                boost::system::error_code ec;
-                returnCode = process::wait_for_exit(child, ec);
-                if(returnCode != 0)
-                    logger.warning("Process ", cmd, " finished with error code ", returnCode);
+    auto st = std::make_shared<State>(reaper.service(), eventReceiver, logger, cmd, limits, stdout_pend, stderr_pend);
+    Logger* log = &logger;
+    std::string name = cmd;
+    // Throws on failure, straight from execute(), there's no waiting for a
+    // thread to report back.
+    reaper.execute([&]{
+        auto start = Trace::clock::now();
+        #if defined BOOST_POSIX_API
+            // Same as execute() with the initializers below, minus the fork().
+            // The pipes don't leak into the child either, but as its stdout
+            // and stderr.
+            pid_t handle = spawnProcess(sargs, env, stdout_pipe.sink, stderr_pipe.sink,
+                { stdout_pipe.source, stderr_pipe.source, stdout_pipe.sink, stderr_pipe.sink });
+            process::child child(handle);
+            terminate_func = [child]() { boost::system::error_code ec; process::terminate(child, ec); };
+            stdout_sink->close();
+            stderr_sink->close();
+        #elif defined BOOST_WINDOWS_API
+            auto child = process::execute(
+                set_args(args),
+                set_env(wenv),
+                bind_stdout(*stdout_sink),
+                bind_stderr(*stderr_sink),
+                close_stdin(),
+                hide_console(),
+                throw_on_error()
+            );
+            // The reaper waits on a duplicate, this one lives as long as terminate_func.
+            HANDLE handle = child.process_handle();
+            auto owned = std::make_shared<process::child>(boost::move(child));
+            terminate_func = [owned]() { TerminateProcess(owned->process_handle(), EXIT_FAILURE); };
+            for(auto i : { stdout_pipe_sink, stderr_pipe_sink })
+                CloseHandle(i);
+        #endif
 
-                // Close the streams and let the io_service thread send a termination message
-                // once it's done reading the data.
-                #if defined BOOST_POSIX_API
-                    stdout_sink->close();
-                    stderr_sink->close();
-                #elif defined BOOST_WINDOWS_API
-                    for(auto i : { stdout_pipe_sink, stderr_pipe_sink })
-                        CloseHandle(i);
-                #endif
-
-            } catch(...) {
-                *e_ptr = std::current_exception();
-            }
+        // The termination message goes out once the process has been reaped
+        // and both pipes are read to the end.
+        reaper.watch(handle, [st, start, name, log](int status, const ProcessReaper::Usage& usage){
+            Trace::complete("process", start, Trace::clock::now(), name);
+            st->returnCode = status;
+            st->usage = usage;
+            if(status != 0)
+                log->warning("Process ", name, " finished with error code ", status);
+            st->finished();
         });
-        if(waitForExitThread.try_join_for(boost::chrono::milliseconds(100)) && *e_ptr)
-            std::rethrow_exception(*e_ptr);
-    } catch(boost::system::system_error e) {
-        throw e;
-    }
-
-    // gajop look away
-    //
-    // Just look at the shitloa... multitude of shared_ptrs this uses.
-    // How the hell does this even compile.
-    // I don't know if I should laugh or cry.
-    auto stdoutBuf = std::make_shared<asio::streambuf>();
-    auto stderrBuf = std::make_shared<asio::streambuf>();
-    auto onRead = std::make_shared<std::function<void(const boost::system::error_code&, std::size_t)> >();
-    auto onErrRead = std::make_shared<std::function<void(const boost::system::error_code&, std::size_t)> >();
-    *onRead = [=](const boost::system::error_code& ec, std::size_t /* bytes */){
-        if(!ec) {
-            std::istream is(stdoutBuf.get());
-            std::string msg;
-            std::getline(is, msg);
-            QCoreApplication::postEvent(eventReceiver, new ReadEvent(cmd, msg));
-            asio::async_read_until(*stdout_pend, *stdoutBuf, &matchNewline, *onRead);
-        }
-    };
-    *onErrRead = [=](const boost::system::error_code& ec, std::size_t /* bytes */){
-        if(!ec) {
-            std::istream is(stderrBuf.get());
-            std::string msg;
-            std::getline(is, msg);
-            QCoreApplication::postEvent(eventReceiver, new ReadEvent(cmd, msg));
-            asio::async_read_until(*stderr_pend, *stderrBuf, &matchNewline, *onErrRead);
-        }
-    };
-    asio::async_read_until(*stdout_pend, *stdoutBuf, &matchNewline, *onRead);
-    asio::async_read_until(*stderr_pend, *stderrBuf, &matchNewline, *onErrRead);
+        st->read(*st->stdoutPend, st->stdoutFramer);
+        st->read(*st->stderrPend, st->stderrFramer);
+    });
+    state = st;
+}
 
-    runServiceThread = boost::thread(boost::bind(&ProcessRunner::runService, this));
+std::string ProcessRunner::fileName(const std::string& cmd) {
+    std::string name = cmd;
+    for(auto& c : name) {
+        if(!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.')
+            c = '_';
+    }
+    return name;
 }
 
 void ProcessRunner::terminate() {
     try {
-        terminate_func();
+        if(terminate_func)
+            terminate_func();
     } catch(boost::system::system_error e) {
         logger.warning("Error terminating process ", cmd, ": ", e.what());
     }
 }
 
+// Nothing is posted for a process once its runner is gone, but it's still
+// reaped.
 ProcessRunner::~ProcessRunner() {
-    service.stop();
-    if(runServiceThread.joinable())
-        runServiceThread.join();
-    if(waitForExitThread.joinable())
-        waitForExitThread.join();
+    if(!state)
+        return;
+    auto st = state;
+    reaper.service().post([st]{
+        st->detached = true;
+        st->flushTimer.cancel();
+        boost::system::error_code ec;
+        st->stdoutPend->close(ec);
+        st->stderrPend->close(ec);
+    });
 }
 
-ProcessRunner::ProcessRunner(QObject* eventReceiver, Logger& logger, const std::string& cmd,
-        const std::vector<std::wstring>& args) : eventReceiver(eventReceiver), logger(logger), cmd(cmd), args(args) {
+ProcessRunner::ProcessRunner(QObject* eventReceiver, Logger& logger, ProcessReaper& reaper, const std::string& cmd,
+        const std::vector<std::wstring>& args, const OutputLimits& limits) : eventReceiver(eventReceiver),
+        logger(logger), reaper(reaper), cmd(cmd), args(args), limits(limits) {
 }
 
-ProcessRunner::ProcessRunner(ProcessRunner&& p) : eventReceiver(p.eventReceiver), logger(p.logger), cmd(p.cmd), args(p.args) {}
-
-void ProcessRunner::runService() {
-    service.run();
-    if(waitForExitThread.joinable())
-        waitForExitThread.join();
-    QCoreApplication::postEvent(eventReceiver, new TerminateEvent(cmd, returnCode));
-}
+ProcessRunner::ProcessRunner(ProcessRunner&& p) : eventReceiver(p.eventReceiver), logger(p.logger), reaper(p.reaper),
+        cmd(p.cmd), args(p.args), limits(p.limits), terminate_func(std::move(p.terminate_func)),
+        state(std::move(p.state)) {}
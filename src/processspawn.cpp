@@ -0,0 +1,52 @@
+#include "processspawn.h"
+
+#ifdef BOOST_POSIX_API
+
+#include <boost/system/system_error.hpp>
+#include <cerrno>
+#include <spawn.h>
+#include <unistd.h>
+
+namespace {
+
+struct FileActions {
+    FileActions() { posix_spawn_file_actions_init(&actions); }
+    ~FileActions() { posix_spawn_file_actions_destroy(&actions); }
+    posix_spawn_file_actions_t actions;
+};
+
+void check(int err, const char* what) {
+    if (err != 0)
+        throw boost::system::system_error(boost::system::error_code(err, boost::system::system_category()), what);
+}
+
+std::vector<char*> toArgv(const std::vector<std::string>& strings) {
+    std::vector<char*> argv;
+    for (auto& s : strings)
+        argv.push_back(const_cast<char*>(s.c_str()));
+    argv.push_back(NULL);
+    return argv;
+}
+
+}
+
+// The dup2()s go first, a descriptor to close may be the source of one.
+pid_t spawnProcess(const std::vector<std::string>& args, const std::vector<std::string>& env, int stdoutFd,
+        int stderrFd, const std::vector<int>& closeFds) {
+    if (args.empty())
+        check(EINVAL, "posix_spawn(3) failed: no program");
+    FileActions fa;
+    check(posix_spawn_file_actions_adddup2(&fa.actions, stdoutFd, STDOUT_FILENO), "posix_spawn_file_actions_adddup2");
+    check(posix_spawn_file_actions_adddup2(&fa.actions, stderrFd, STDERR_FILENO), "posix_spawn_file_actions_adddup2");
+    check(posix_spawn_file_actions_addclose(&fa.actions, STDIN_FILENO), "posix_spawn_file_actions_addclose");
+    for (int fd : closeFds) {
+        if (fd > STDERR_FILENO)
+            check(posix_spawn_file_actions_addclose(&fa.actions, fd), "posix_spawn_file_actions_addclose");
+    }
+    std::vector<char*> argv = toArgv(args), envp = toArgv(env);
+    pid_t pid;
+    check(posix_spawn(&pid, args[0].c_str(), &fa.actions, NULL, argv.data(), envp.data()), "posix_spawn(3) failed");
+    return pid;
+}
+
+#endif // BOOST_POSIX_API
@@ -0,0 +1,29 @@
+#ifndef PROCESSSPAWN_H
+#define PROCESSSPAWN_H
+
+// Starts child processes with posix_spawn() instead of fork() + exec().
+// fork() copies the page tables of the whole weblobby process, QtWebKit heap
+// included, which makes every launch take milliseconds and briefly doubles
+// the commit charge. glibc implements posix_spawn() with
+// clone(CLONE_VM | CLONE_VFORK), nothing is copied and exec() errors are
+// still reported to the caller.
+
+#include <boost/process/config.hpp>
+#include <string>
+#include <vector>
+
+#ifdef BOOST_POSIX_API
+
+#include <sys/types.h>
+
+// Runs args[0] (not looked up in PATH) with args as argv and env as its whole
+// environment. stdout and stderr go to the given descriptors, stdin is
+// closed, fds in closeFds are closed in the child. These are the semantics
+// of boost::process::execute() with set_args, set_env, bind_stdout,
+// bind_stderr and close_stdin. Throws boost::system::system_error.
+pid_t spawnProcess(const std::vector<std::string>& args, const std::vector<std::string>& env, int stdoutFd,
+    int stderrFd, const std::vector<int>& closeFds = std::vector<int>());
+
+#endif // BOOST_POSIX_API
+
+#endif // PROCESSSPAWN_H
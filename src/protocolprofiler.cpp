@@ -0,0 +1,142 @@
+#include "protocolprofiler.h"
+#include <algorithm>
+#include <sstream>
+
+const int ProtocolProfiler::windows[3] = { 1, 10, 60 };
+
+ProtocolProfiler::ProtocolProfiler() : start(clock::now()) {}
+
+std::string ProtocolProfiler::commandOf(const std::string& line) {
+    std::size_t begin = 0;
+    if (!line.empty() && line[0] == '#') {
+        begin = line.find(' ');
+        if (begin == std::string::npos)
+            return std::string();
+        begin++;
+    }
+    std::size_t end = line.find_first_of(" \r", begin);
+    return line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+long long ProtocolProfiler::now() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(clock::now() - start).count();
+}
+
+ProtocolProfiler::Entry& ProtocolProfiler::entry(const std::string& command) {
+    auto it = entries.find(command);
+    if (it == entries.end()) {
+        it = entries.insert(std::make_pair(command, Entry())).first;
+        for (auto& s : it->second.seconds)
+            s.second = -1;
+    }
+    return it->second;
+}
+
+// Bytes include the '\n'.
+void ProtocolProfiler::countLocked(Direction dir, const std::string& line, long long sec) {
+    Entry& e = entry(commandOf(line));
+    e.stats.messages[dir]++;
+    e.stats.bytes[dir] += line.size() + 1;
+    Second& s = e.seconds[sec % e.seconds.size()];
+    if (s.second != sec) {
+        s.second = sec;
+        s.messages = s.bytes = 0;
+    }
+    s.messages++;
+    s.bytes += line.size() + 1;
+}
+
+void ProtocolProfiler::count(Direction dir, const std::vector<std::string>& lines) {
+    long long sec = now();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& line : lines)
+        countLocked(dir, line, sec);
+}
+
+void ProtocolProfiler::count(Direction dir, const std::string& line) {
+    long long sec = now();
+    std::lock_guard<std::mutex> lock(mutex);
+    countLocked(dir, line, sec);
+}
+
+void ProtocolProfiler::addParseTimes(const Timings& timings) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& t : timings) {
+        CommandStats& stats = entry(t.first).stats;
+        stats.parsed++;
+        stats.parseTime += t.second;
+    }
+}
+
+void ProtocolProfiler::addDispatchTimes(const Timings& convert, clock::duration jsShare) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& t : convert) {
+        CommandStats& stats = entry(t.first).stats;
+        stats.dispatched++;
+        stats.convertTime += t.second;
+        stats.jsShareTime += jsShare;
+    }
+}
+
+std::map<std::string, ProtocolProfiler::CommandStats> ProtocolProfiler::commands() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, CommandStats> res;
+    for (auto& e : entries)
+        res[e.first] = e.second.stats;
+    return res;
+}
+
+// The current second is still filling up, windows end with the last
+// complete one.
+std::vector<ProtocolProfiler::Rates> ProtocolProfiler::top(std::size_t n) const {
+    long long sec = now();
+    std::vector<Rates> res;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& e : entries) {
+            Rates rates = { e.first, { 0, 0, 0 }, { 0, 0, 0 } };
+            for (auto& s : e.second.seconds) {
+                long long age = sec - s.second;
+                for (int w = 0; w < 3; w++) {
+                    if (s.second >= 0 && age >= 1 && age <= windows[w]) {
+                        rates.messages[w] += s.messages;
+                        rates.bytes[w] += s.bytes;
+                    }
+                }
+            }
+            if (rates.bytes[2] == 0)
+                continue;
+            for (int w = 0; w < 3; w++) {
+                int span = std::max(1, int(std::min<long long>(windows[w], sec)));
+                rates.messages[w] /= span;
+                rates.bytes[w] /= span;
+            }
+            res.push_back(rates);
+        }
+    }
+    std::sort(res.begin(), res.end(), [](const Rates& a, const Rates& b) { return a.bytes[2] > b.bytes[2]; });
+    if (res.size() > n)
+        res.resize(n);
+    return res;
+}
+
+std::string ProtocolProfiler::summary(std::size_t n) const {
+    auto stats = commands();
+    std::vector<std::pair<std::string, CommandStats>> sorted(stats.begin(), stats.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, CommandStats>& a,
+            const std::pair<std::string, CommandStats>& b) {
+        return a.second.bytes[in] + a.second.bytes[out] > b.second.bytes[in] + b.second.bytes[out];
+    });
+    std::ostringstream ss;
+    for (std::size_t i = 0; i < sorted.size() && i < n; i++) {
+        const CommandStats& s = sorted[i].second;
+        if (i)
+            ss << ", ";
+        ss << (sorted[i].first.empty() ? "(empty)" : sorted[i].first) << " " << s.messages[in] << "/" << s.bytes[in]
+            << " in " << s.messages[out] << "/" << s.bytes[out] << " out";
+        if (s.dispatched)
+            ss << " " << std::chrono::duration<double, std::micro>(s.convertTime).count() / s.dispatched
+                << " us converting each";
+    }
+    return ss.str();
+}
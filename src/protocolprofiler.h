@@ -0,0 +1,78 @@
+#ifndef PROTOCOLPROFILER_H
+#define PROTOCOLPROFILER_H
+
+// Traffic of a lobby connection broken down by command word: messages and
+// bytes in each direction, time spent tokenizing in the network thread and
+// handling in the GUI thread, and per second counts of the last minute for
+// rates. Counted from the network and the GUI thread, queried from either.
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ProtocolProfiler {
+public:
+    typedef std::chrono::steady_clock clock;
+    enum Direction { in, out };
+
+    ProtocolProfiler();
+
+    // The command word of a line, after an optional "#id".
+    static std::string commandOf(const std::string& line);
+
+    void count(Direction, const std::vector<std::string>& lines);
+    void count(Direction, const std::string& line);
+    // Times are added up per command, pass them in batches.
+    typedef std::vector<std::pair<std::string, clock::duration>> Timings;
+    void addParseTimes(const Timings&);
+    // convert is what each line took to be turned into a JS call, measured
+    // per line. JS is called for whole batches, jsShare is that call split
+    // evenly over the lines of the batch.
+    void addDispatchTimes(const Timings& convert, clock::duration jsShare);
+
+    struct CommandStats {
+        CommandStats() : messages(), bytes(), parsed(0), dispatched(0), parseTime(0), convertTime(0), jsShareTime(0) {}
+        unsigned long long messages[2], bytes[2];
+        unsigned long long parsed, dispatched;
+        // Added up at clock resolution, a single line takes well under a
+        // microsecond to tokenize.
+        clock::duration parseTime, convertTime;
+        // An estimate, the JS time of a single command isn't measured.
+        clock::duration jsShareTime;
+    };
+    std::map<std::string, CommandStats> commands() const;
+
+    // Messages and bytes per second of a command in both directions over
+    // the last 1, 10 and 60 seconds.
+    struct Rates {
+        std::string command;
+        double messages[3], bytes[3];
+    };
+    static const int windows[3];
+    // The n commands with the most bytes in the last minute.
+    std::vector<Rates> top(std::size_t n) const;
+
+    // One line for the log, the n commands with the most bytes overall.
+    std::string summary(std::size_t n) const;
+private:
+    struct Second {
+        long long second;
+        unsigned long long messages, bytes;
+    };
+    struct Entry {
+        CommandStats stats;
+        std::array<Second, 60> seconds;
+    };
+    Entry& entry(const std::string& command);
+    void countLocked(Direction, const std::string& line, long long now);
+    long long now() const;
+
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+    clock::time_point start;
+};
+
+#endif // PROTOCOLPROFILER_H
@@ -0,0 +1,106 @@
+#include "sessioncapture.h"
+#include <cstdlib>
+#include <ctime>
+#include <boost/filesystem/fstream.hpp>
+#include "ufstream.h"
+
+static const std::size_t writeChunk = 65536;
+
+CaptureWriter::CaptureWriter() : lineCount(0) {}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const boost::filesystem::path& path) {
+    close();
+    std::unique_ptr<std::ostream> file(new uofstream(path, std::ios::binary));
+    if (!file->good())
+        return false;
+    out = std::move(file);
+    filePath = path;
+    zstream.reset();
+    pending = "WLCAP 1 " + std::to_string((long long)std::time(NULL)) + "\n";
+    last = std::chrono::steady_clock::now();
+    lineCount = 0;
+    return true;
+}
+
+void CaptureWriter::record(bool sent, const std::string& line) {
+    if (!out)
+        return;
+    auto now = std::chrono::steady_clock::now();
+    pending += std::to_string((long long)std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+    pending += sent ? " s " : " r ";
+    pending += line;
+    pending += '\n';
+    last = now;
+    lineCount++;
+    if (pending.size() >= writeChunk)
+        write();
+}
+
+void CaptureWriter::close() {
+    if (!out)
+        return;
+    write();
+    out.reset();
+}
+
+// Compressed and sync flushed a chunk at a time, a crash loses at most the
+// last chunk.
+void CaptureWriter::write() {
+    deflated.clear();
+    zstream.compress(pending.data(), pending.size(), true, deflated);
+    pending.clear();
+    out->write(deflated.data(), deflated.size());
+    out->flush();
+}
+
+bool readCapture(const boost::filesystem::path& path, std::vector<CaptureRecord>& records, std::string& error) {
+    uifstream in(path, std::ios::binary);
+    if (!in.good()) {
+        error = "could not open " + path.string();
+        return false;
+    }
+    DeflateStream zstream;
+    LineFramer framer;
+    std::vector<char> buf(writeChunk);
+    std::vector<std::string> lines;
+    bool header = false;
+    long long timeUs = 0;
+    while (in) {
+        in.read(buf.data(), buf.size());
+        lines.clear();
+        if (!zstream.decompress(buf.data(), in.gcount(), framer, lines)) {
+            error = "corrupt capture: " + zstream.error();
+            return false;
+        }
+        framer.extract(lines);
+        for (auto& line : lines) {
+            if (!header) {
+                if (line.compare(0, 8, "WLCAP 1 ") != 0) {
+                    error = "not a capture file";
+                    return false;
+                }
+                header = true;
+                continue;
+            }
+            // "<delta> <r|s> <line>"
+            char* end;
+            timeUs += std::strtoll(line.c_str(), &end, 10);
+            std::size_t pos = end - line.c_str();
+            if (pos + 3 > line.size() || line[pos] != ' ' || line[pos + 2] != ' ') {
+                error = "corrupt capture record";
+                return false;
+            }
+            CaptureRecord record = { timeUs, line[pos + 1] == 's', line.substr(pos + 3) };
+            records.push_back(std::move(record));
+        }
+    }
+    if (!header) {
+        error = "empty capture";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef SESSIONCAPTURE_H
+#define SESSIONCAPTURE_H
+
+// Recording of lobby sessions, every line received and sent with the time it
+// went by, so that a login burst or a busy evening can be replayed offline.
+// A capture is a zlib stream of text lines, first "WLCAP 1 <unix time>", then
+// one per protocol line: "<us since the previous one> <r|s> <line>".
+
+#include "deflatestream.h"
+#include "lineframer.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <boost/filesystem/path.hpp>
+
+class CaptureWriter {
+public:
+    CaptureWriter();
+    ~CaptureWriter();
+
+    bool open(const boost::filesystem::path&);
+    void record(bool sent, const std::string& line);
+    // Flushes everything and closes the file.
+    void close();
+    bool isOpen() const { return out != NULL; }
+    const boost::filesystem::path& path() const { return filePath; }
+    unsigned long long lines() const { return lineCount; }
+private:
+    void write();
+
+    std::unique_ptr<std::ostream> out;
+    boost::filesystem::path filePath;
+    DeflateStream zstream;
+    // Plain lines waiting to be compressed and what came out of it.
+    std::string pending, deflated;
+    std::chrono::steady_clock::time_point last;
+    unsigned long long lineCount;
+};
+
+struct CaptureRecord {
+    // Since the capture was started.
+    long long timeUs;
+    bool sent;
+    std::string line;
+};
+
+// Reads a whole capture. Returns false and sets error if it can't.
+bool readCapture(const boost::filesystem::path&, std::vector<CaptureRecord>& records, std::string& error);
+
+#endif // SESSIONCAPTURE_H
@@ -0,0 +1,193 @@
+#include "trace.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <boost/filesystem/fstream.hpp>
+#include "ufstream.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace Trace {
+
+std::atomic<bool> isEnabled(false);
+
+namespace {
+
+struct Record {
+    const char* name;
+    char phase; // 'X' complete, 'C' counter, 'i' instant
+    long long ts, value; // value is the duration for 'X'
+    char arg[40];
+};
+
+// Written only by its own thread. count is published with release semantics
+// after the record is complete, so dump() never sees half a record.
+struct ThreadBuffer {
+    static const std::size_t capacity = 1 << 16;
+    ThreadBuffer(int tid) : tid(tid), count(0), dropped(0), records(new Record[capacity]) {}
+    int tid;
+    std::string name;
+    std::atomic<std::size_t> count;
+    std::atomic<std::size_t> dropped;
+    std::unique_ptr<Record[]> records;
+};
+
+struct Registry {
+    boost::mutex mutex;
+    // Buffers outlive their threads so that detached threads show up too.
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    clock::time_point epoch;
+    boost::filesystem::path dumpPath;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+ThreadBuffer& threadBuffer() {
+    static thread_local ThreadBuffer* buf = NULL;
+    if (!buf) {
+        Registry& r = registry();
+        boost::lock_guard<boost::mutex> lock(r.mutex);
+        r.buffers.emplace_back(new ThreadBuffer(r.buffers.size() + 1));
+        buf = r.buffers.back().get();
+    }
+    return *buf;
+}
+
+long long toUs(clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - registry().epoch).count();
+}
+
+void record(const char* name, char phase, long long ts, long long value, const std::string& arg) {
+    ThreadBuffer& buf = threadBuffer();
+    std::size_t n = buf.count.load(std::memory_order_relaxed);
+    if (n == ThreadBuffer::capacity) {
+        buf.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Record& r = buf.records[n];
+    r.name = name;
+    r.phase = phase;
+    r.ts = ts;
+    r.value = value;
+    std::size_t len = std::min(arg.size(), sizeof(r.arg) - 1);
+    std::memcpy(r.arg, arg.data(), len);
+    r.arg[len] = '\0';
+    buf.count.store(n + 1, std::memory_order_release);
+}
+
+void appendJsonString(std::string& out, const char* str) {
+    out += '"';
+    for (; *str; str++) {
+        unsigned char c = *str;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c < 0x20) {
+            char esc[8];
+            std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+}
+
+void start() {
+    registry().epoch = clock::now();
+    isEnabled = true;
+    setThreadName("gui");
+}
+
+void setThreadName(const std::string& name) {
+    if (enabled())
+        threadBuffer().name = name;
+}
+
+void complete(const char* name, clock::time_point start, clock::time_point end, const std::string& arg) {
+    if (enabled())
+        record(name, 'X', toUs(start), std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), arg);
+}
+
+void counter(const char* name, long long value) {
+    if (enabled())
+        record(name, 'C', toUs(clock::now()), value, "");
+}
+
+void instant(const char* name, const std::string& arg) {
+    if (enabled())
+        record(name, 'i', toUs(clock::now()), 0, arg);
+}
+
+void setDumpPath(const boost::filesystem::path& path) {
+    registry().dumpPath = path;
+}
+
+const boost::filesystem::path& dumpPath() {
+    return registry().dumpPath;
+}
+
+bool dump() {
+    uofstream out(registry().dumpPath, std::ios::binary);
+    if (!out.good())
+        return false;
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto sep = [&]() {
+        json += first ? "" : ",\n";
+        first = false;
+    };
+    Registry& r = registry();
+    boost::lock_guard<boost::mutex> lock(r.mutex);
+    for (auto& buf : r.buffers) {
+        std::string tid = std::to_string(buf->tid);
+        if (!buf->name.empty()) {
+            sep();
+            json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+            appendJsonString(json, buf->name.c_str());
+            json += "}}";
+        }
+        std::size_t n = buf->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; i++) {
+            const Record& rec = buf->records[i];
+            sep();
+            json += "{\"ph\":\"";
+            json += rec.phase;
+            json += "\",\"name\":";
+            appendJsonString(json, rec.name);
+            json += ",\"pid\":1,\"tid\":" + tid + ",\"ts\":" + std::to_string(rec.ts);
+            if (rec.phase == 'X')
+                json += ",\"dur\":" + std::to_string(rec.value);
+            else if (rec.phase == 'i')
+                json += ",\"s\":\"t\"";
+            if (rec.phase == 'C') {
+                json += ",\"args\":{\"value\":" + std::to_string(rec.value) + "}";
+            } else if (rec.arg[0]) {
+                json += ",\"args\":{\"arg\":";
+                appendJsonString(json, rec.arg);
+                json += "}";
+            }
+            json += "}";
+            if (json.size() > (1 << 20)) {
+                out << json;
+                json.clear();
+            }
+        }
+        if (buf->dropped) {
+            sep();
+            json += "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"trace buffer full, " + std::to_string(buf->dropped) +
+                " records dropped\",\"pid\":1,\"tid\":" + tid + ",\"ts\":0}";
+        }
+    }
+    json += "\n]}\n";
+    out << json;
+    return out.good();
+}
+
+}
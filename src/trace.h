@@ -0,0 +1,62 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Cross-thread timeline tracing, dumped in the Chrome trace event format
+// (chrome://tracing, ui.perfetto.dev). Every thread records into its own
+// fixed size buffer that only it writes to, so recording takes no locks.
+// When tracing is off, which is the default, recording is a single branch.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+namespace Trace {
+
+typedef std::chrono::steady_clock clock;
+
+extern std::atomic<bool> isEnabled;
+
+// Enables recording, call it before spawning any threads.
+void start();
+inline bool enabled() {
+    return isEnabled.load(std::memory_order_relaxed);
+}
+// Where dump() writes the trace.
+void setDumpPath(const boost::filesystem::path&);
+const boost::filesystem::path& dumpPath();
+// Writes everything recorded so far as JSON.
+bool dump();
+
+// Names the calling thread in the trace.
+void setThreadName(const std::string&);
+
+// name must be a string literal, arg is truncated to a few dozen characters.
+void complete(const char* name, clock::time_point start, clock::time_point end, const std::string& arg = "");
+void counter(const char* name, long long value);
+void instant(const char* name, const std::string& arg = "");
+
+}
+
+// Records the lifetime of the scope as a span.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const std::string& arg = "") : name(name) {
+        if (Trace::enabled()) {
+            this->arg = arg;
+            start = Trace::clock::now();
+        }
+    }
+    ~TraceSpan() {
+        if (Trace::enabled() && start != Trace::clock::time_point())
+            Trace::complete(name, start, Trace::clock::now(), arg);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+private:
+    const char* name;
+    std::string arg;
+    Trace::clock::time_point start;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,335 @@
+#include "udpprober.h"
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+    #include <linux/errqueue.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+namespace asio = boost::asio;
+using asio::ip::udp;
+
+struct UdpProber::Request {
+    Request(unsigned int id, asio::io_service& service) : id(id), attemptTimer(service), flushTimer(service),
+        attempt(0), left(0), flushPending(false) {}
+    unsigned int id;
+    std::vector<Target> targets;
+    std::vector<Endpoint> endpoints;
+    // Targets that have a result, whether it went out or not.
+    std::vector<bool> done;
+    Options options;
+    Callback callback;
+    asio::steady_timer attemptTimer, flushTimer;
+    unsigned int attempt;
+    // Targets still being probed.
+    std::size_t left;
+    bool flushPending;
+    std::vector<Result> ready;
+};
+
+static const char probeMagic[] = "WLPROBE ";
+static const std::size_t probeMagicLen = sizeof(probeMagic) - 1;
+
+// Returns false if data isn't one of our probes.
+static bool parseProbe(const char* data, std::size_t len, std::uint32_t& seq) {
+    if (len <= probeMagicLen || std::memcmp(data, probeMagic, probeMagicLen) != 0)
+        return false;
+    std::string digits(data + probeMagicLen, len - probeMagicLen);
+    char* end;
+    unsigned long n = std::strtoul(digits.c_str(), &end, 10);
+    if (end == digits.c_str())
+        return false;
+    seq = n;
+    return true;
+}
+
+UdpProber::UdpProber(asio::io_service& service, Logger& logger) : service(service), logger(logger), socket(service),
+    receiving(false), nextSeq(1) {}
+
+UdpProber::~UdpProber() {
+    cancelAll();
+}
+
+const char* UdpProber::statusName(Result::Status status) {
+    switch (status) {
+    case Result::reply: return "reply";
+    case Result::icmp: return "icmp";
+    case Result::timeout: return "timeout";
+    default: return "error";
+    }
+}
+
+// Addresses that can't be probed and fresh cache entries are answered right
+// away, in the first batch.
+void UdpProber::probe(unsigned int id, const std::vector<Target>& targets, Options options, Callback callback) {
+    requests.erase(id);
+    auto now = clock::now();
+    auto maxAge = std::chrono::milliseconds(options.maxAge);
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (now - it->second.time > maxAge)
+            cache.erase(it++);
+        else
+            ++it;
+    }
+
+    std::unique_ptr<Request> req(new Request(id, service));
+    req->targets = targets;
+    req->endpoints.resize(targets.size());
+    req->done.resize(targets.size(), false);
+    req->options = options;
+    req->options.attempts = std::max(options.attempts, 1u);
+    req->callback = callback;
+    for (std::size_t i = 0; i < targets.size(); i++) {
+        Result res = { targets[i].host, targets[i].port, Result::failed, -1, false, "" };
+        boost::system::error_code ec;
+        asio::ip::address address = asio::ip::address::from_string(targets[i].host, ec);
+        if (ec || !address.is_v4() || targets[i].port == 0 || targets[i].port > 65535) {
+            res.error = "not an IPv4 address and port";
+        } else {
+            req->endpoints[i] = Endpoint(address, targets[i].port);
+            auto cached = cache.find(req->endpoints[i]);
+            if (cached == cache.end()) {
+                req->left++;
+                continue;
+            }
+            res.status = cached->second.status;
+            res.rttUs = cached->second.rttUs;
+            res.cached = true;
+        }
+        req->done[i] = true;
+        req->ready.push_back(res);
+    }
+    if (req->left && !open()) {
+        for (std::size_t i = 0; i < targets.size(); i++) {
+            if (!req->done[i]) {
+                Result res = { targets[i].host, targets[i].port, Result::failed, -1, false, "could not open socket" };
+                req->ready.push_back(res);
+            }
+        }
+        req->left = 0;
+    }
+    requests[id] = std::move(req);
+    if (requests[id]->left == 0) {
+        flush(id);
+        return;
+    }
+    startReceive();
+    sendAttempt(id);
+    if (requests.count(id) && !requests[id]->ready.empty())
+        scheduleFlush(id);
+}
+
+void UdpProber::cancelAll() {
+    requests.clear();
+    pending.clear();
+    boost::system::error_code ec;
+    socket.close(ec);
+}
+
+bool UdpProber::open() {
+    if (socket.is_open())
+        return true;
+    boost::system::error_code ec;
+    socket.open(udp::v4(), ec);
+    if (!ec)
+        socket.non_blocking(true, ec);
+    if (ec) {
+        logger.error("Could not open UDP probe socket: ", ec.message());
+        socket.close(ec);
+        return false;
+    }
+#ifdef __linux__
+    int on = 1;
+    if (setsockopt(socket.native_handle(), SOL_IP, IP_RECVERR, &on, sizeof(on)) != 0)
+        logger.warning("Could not enable IP_RECVERR, ICMP errors won't count as answers");
+#endif
+    return true;
+}
+
+// Waits for readiness only, everything queued is then read without blocking.
+// An ICMP error makes the socket ready as well. The wait is aborted when the
+// socket is closed, it may have been opened again for a new request since.
+void UdpProber::startReceive() {
+    if (receiving)
+        return;
+    receiving = true;
+    socket.async_receive(asio::null_buffers(), [this](const boost::system::error_code& ec, std::size_t){
+        receiving = false;
+        if (!socket.is_open())
+            return;
+        if (!ec) {
+            drainErrors();
+            drain();
+        }
+        if (!requests.empty())
+            startReceive();
+    });
+}
+
+// A pending ICMP error is also reported once by the next receive, on
+// Windows that is all there is of it.
+void UdpProber::drain() {
+    char buf[512];
+    for (;;) {
+        Endpoint from;
+        boost::system::error_code ec;
+        std::size_t len = socket.receive_from(asio::buffer(buf), from, 0, ec);
+        if (ec == asio::error::connection_refused || ec == asio::error::connection_reset)
+            continue;
+        if (ec)
+            break;
+        std::uint32_t seq;
+        if (parseProbe(buf, len, seq))
+            answer(seq, from, Result::reply, "");
+    }
+}
+
+// The error queue holds the ICMP error, the destination of the probe that
+// caused it and the probe's payload. Port unreachable comes from the host
+// itself and is as good as a reply, anything else is an error for the host.
+void UdpProber::drainErrors() {
+#ifdef __linux__
+    for (;;) {
+        char buf[512], control[512];
+        sockaddr_in dest;
+        iovec iov = { buf, sizeof(buf) };
+        msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &dest;
+        msg.msg_namelen = sizeof(dest);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t len = recvmsg(socket.native_handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if (len < 0)
+            break;
+        std::uint32_t seq;
+        if (!parseProbe(buf, len, seq) || msg.msg_namelen < sizeof(dest) || dest.sin_family != AF_INET)
+            continue;
+        Endpoint to(asio::ip::address_v4(ntohl(dest.sin_addr.s_addr)), ntohs(dest.sin_port));
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR)
+                continue;
+            auto* err = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cmsg));
+            if (err->ee_origin == SO_EE_ORIGIN_ICMP && err->ee_type == 3 && err->ee_code == 3)
+                answer(seq, to, Result::icmp, "");
+            else
+                answer(seq, to, Result::failed, std::strerror(err->ee_errno));
+        }
+    }
+#endif
+}
+
+// Unanswered targets get another probe each, after the last attempt they
+// time out.
+void UdpProber::sendAttempt(unsigned int id) {
+    auto it = requests.find(id);
+    if (it == requests.end())
+        return;
+    Request& req = *it->second;
+    if (req.attempt == req.options.attempts) {
+        for (std::size_t i = 0; requests.count(id) && i < req.targets.size(); i++) {
+            if (!req.done[i])
+                finish(req, i, Result::timeout, -1, "");
+        }
+        return;
+    }
+    req.attempt++;
+    for (std::size_t i = 0; requests.count(id) && i < req.targets.size(); i++) {
+        if (req.done[i])
+            continue;
+        std::uint32_t seq = nextSeq++;
+        std::string payload = probeMagic + std::to_string(seq);
+        boost::system::error_code ec;
+        socket.send_to(asio::buffer(payload), req.endpoints[i], 0, ec);
+        if (ec) {
+            finish(req, i, Result::failed, -1, ec.message());
+            continue;
+        }
+        Pending p = { id, i, clock::now() };
+        pending[seq] = p;
+    }
+    if (!requests.count(id))
+        return;
+    req.attemptTimer.expires_from_now(std::chrono::milliseconds(req.options.timeout));
+    req.attemptTimer.async_wait([this, id](const boost::system::error_code& ec){
+        if (!ec)
+            sendAttempt(id);
+    });
+}
+
+void UdpProber::answer(std::uint32_t seq, const Endpoint& from, Result::Status status, const std::string& error) {
+    auto it = pending.find(seq);
+    if (it == pending.end())
+        return;
+    Pending p = it->second;
+    auto req = requests.find(p.request);
+    if (req == requests.end() || req->second->endpoints[p.target] != from)
+        return;
+    pending.erase(it);
+    long long rttUs = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - p.sent).count();
+    finish(*req->second, p.target, status, status == Result::failed ? -1 : rttUs, error);
+}
+
+// Finishing the last target hands out the last batch, which destroys req.
+void UdpProber::finish(Request& req, std::size_t target, Result::Status status, long long rttUs,
+        const std::string& error) {
+    if (req.done[target])
+        return;
+    req.done[target] = true;
+    req.left--;
+    if (status != Result::failed) {
+        CacheEntry entry = { status, rttUs, clock::now() };
+        cache[req.endpoints[target]] = entry;
+    }
+    Result res = { req.targets[target].host, req.targets[target].port, status, rttUs, false, error };
+    req.ready.push_back(res);
+    if (req.left == 0)
+        flush(req.id);
+    else
+        scheduleFlush(req.id);
+}
+
+void UdpProber::scheduleFlush(unsigned int id) {
+    Request& req = *requests[id];
+    if (req.flushPending)
+        return;
+    req.flushPending = true;
+    req.flushTimer.expires_from_now(std::chrono::milliseconds(req.options.batchInterval));
+    req.flushTimer.async_wait([this, id](const boost::system::error_code& ec){
+        auto it = requests.find(id);
+        if (ec || it == requests.end())
+            return;
+        it->second->flushPending = false;
+        flush(id);
+    });
+}
+
+// The socket stays open only while there is something to wait for.
+void UdpProber::flush(unsigned int id) {
+    auto it = requests.find(id);
+    if (it == requests.end())
+        return;
+    Request& req = *it->second;
+    bool done = req.left == 0;
+    std::vector<Result> results;
+    results.swap(req.ready);
+    Callback callback = req.callback;
+    if (done) {
+        for (auto p = pending.begin(); p != pending.end();) {
+            if (p->second.request == id)
+                pending.erase(p++);
+            else
+                ++p;
+        }
+        requests.erase(it);
+        if (requests.empty()) {
+            boost::system::error_code ec;
+            socket.close(ec);
+        }
+    }
+    if (done || !results.empty())
+        callback(id, std::move(results), done);
+}
@@ -0,0 +1,100 @@
+#ifndef UDPPROBER_H
+#define UDPPROBER_H
+
+// Round trip times to game hosts, measured with small UDP datagrams sent to
+// many of them at once from a single socket. A host answers either by
+// echoing the probe or, when nothing listens on its port, with an ICMP port
+// unreachable. On Linux the latter is read from the socket's error queue
+// (IP_RECVERR) and is as good a measurement as an echo, elsewhere only
+// echoes count. Results are cached per address and port.
+// Everything but the constructor runs in the thread of the io_service.
+
+#include "logger.h"
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class UdpProber {
+public:
+    struct Target {
+        // A numeric IPv4 address, battle hosts are announced that way.
+        std::string host;
+        unsigned int port;
+    };
+    struct Result {
+        enum Status { reply, icmp, timeout, failed };
+        std::string host;
+        unsigned int port;
+        Status status;
+        // Only for reply and icmp, -1 otherwise.
+        long long rttUs;
+        // Whether this came from the cache instead of a new probe.
+        bool cached;
+        // Why it failed.
+        std::string error;
+    };
+    struct Options {
+        Options() : attempts(2), timeout(1000), batchInterval(50), maxAge(60000) {}
+        // Unanswered hosts are probed again every timeout ms, up to attempts
+        // times, and then given up on.
+        unsigned int attempts, timeout;
+        // Results are handed out at most this often in ms, the last batch
+        // goes out as soon as every host is done.
+        unsigned int batchInterval;
+        // Cached results younger than this many ms are used instead of
+        // probing again. Timeouts are cached too.
+        unsigned int maxAge;
+    };
+    // Gets every batch of results of request id, done is set on the last.
+    typedef std::function<void(unsigned int id, std::vector<Result>&& results, bool done)> Callback;
+
+    UdpProber(boost::asio::io_service&, Logger&);
+    ~UdpProber();
+
+    void probe(unsigned int id, const std::vector<Target>& targets, Options options, Callback callback);
+    // Drops all requests without calling back and closes the socket.
+    void cancelAll();
+    static const char* statusName(Result::Status);
+private:
+    typedef boost::asio::ip::udp::endpoint Endpoint;
+    typedef std::chrono::steady_clock clock;
+    struct Request;
+    struct Pending {
+        unsigned int request;
+        std::size_t target;
+        clock::time_point sent;
+    };
+    struct CacheEntry {
+        Result::Status status;
+        long long rttUs;
+        clock::time_point time;
+    };
+    bool open();
+    void startReceive();
+    void drain();
+    void drainErrors();
+    void sendAttempt(unsigned int id);
+    void answer(std::uint32_t seq, const Endpoint& from, Result::Status, const std::string& error);
+    void finish(Request&, std::size_t target, Result::Status, long long rttUs, const std::string& error);
+    void scheduleFlush(unsigned int id);
+    void flush(unsigned int id);
+
+    boost::asio::io_service& service;
+    Logger& logger;
+    boost::asio::ip::udp::socket socket;
+    bool receiving;
+    // Sequence numbers go into the payload, so replies and the payloads
+    // returned with ICMP errors can be matched.
+    std::uint32_t nextSeq;
+    std::map<std::uint32_t, Pending> pending;
+    std::map<unsigned int, std::unique_ptr<Request>> requests;
+    std::map<Endpoint, CacheEntry> cache;
+};
+
+#endif // UDPPROBER_H
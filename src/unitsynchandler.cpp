@@ -1,6 +1,7 @@
 // DO NOT EDIT: THIS FILE WAS GENERATED by unitsync wrapper generator
 // from unitsynchandler.cpp.template. Edit that file instead.
 #include "unitsynchandler.h"
+#include "watchdog.h"
 #include <cstdio> // good ol' snprintf
 #if defined Q_OS_LINUX || defined Q_OS_MAC
     #include <dlfcn.h>
@@ -555,6 +556,7 @@ UnitsyncHandler::UnitsyncHandler(UnitsyncHandler&& h) : QObject(h.parent()),
 
 // Returns a %-escaped string ready for use in a data URL.
 QString UnitsyncHandler::jsReadFileVFS(int fd, int size) {
+    Activity activity("unitsync jsReadFileVFS");
     // An astute reader might ask at this point "But ikinz, why in the world do you need that offset?"
     // It turns out that on mingw from mingw-builds v4.8.1-posix-dwarf-rev5 using qt-5.2.0 in this very
     // functions suddenly appears an unknown and unstoppable force that overwrites the first few bytes
@@ -584,6 +586,7 @@ QString UnitsyncHandler::getNextError() {
         logger.error("Bad function pointer: GetNextError");
         throw bad_fptr("GetNextError");
     }
+    Activity activity("unitsync GetNextError");
     logger.debug("call GetNextError(", ")");
     return QString(fptr_GetNextError());
 }
@@ -592,6 +595,7 @@ QString UnitsyncHandler::getSpringVersion() {
         logger.error("Bad function pointer: GetSpringVersion");
         throw bad_fptr("GetSpringVersion");
     }
+    Activity activity("unitsync GetSpringVersion");
     logger.debug("call GetSpringVersion(", ")");
     return QString(fptr_GetSpringVersion());
 }
@@ -600,6 +604,7 @@ QString UnitsyncHandler::getSpringVersionPatchset() {
         logger.error("Bad function pointer: GetSpringVersionPatchset");
         throw bad_fptr("GetSpringVersionPatchset");
     }
+    Activity activity("unitsync GetSpringVersionPatchset");
     logger.debug("call GetSpringVersionPatchset(", ")");
     return QString(fptr_GetSpringVersionPatchset());
 }
@@ -608,6 +613,7 @@ bool UnitsyncHandler::isSpringReleaseVersion() {
         logger.error("Bad function pointer: IsSpringReleaseVersion");
         throw bad_fptr("IsSpringReleaseVersion");
     }
+    Activity activity("unitsync IsSpringReleaseVersion");
     logger.debug("call IsSpringReleaseVersion(", ")");
     return fptr_IsSpringReleaseVersion();
 }
@@ -616,6 +622,7 @@ int UnitsyncHandler::init(bool isServer, int id) {
         logger.error("Bad function pointer: Init");
         throw bad_fptr("Init");
     }
+    Activity activity("unitsync Init");
     logger.debug("call Init(", isServer, ", ", id, ")");
     return fptr_Init(isServer, id);
 }
@@ -624,6 +631,7 @@ void UnitsyncHandler::unInit() {
         logger.error("Bad function pointer: UnInit");
         throw bad_fptr("UnInit");
     }
+    Activity activity("unitsync UnInit");
     logger.debug("call UnInit(", ")");
     return fptr_UnInit();
 }
@@ -632,6 +640,7 @@ QString UnitsyncHandler::getWritableDataDirectory() {
         logger.error("Bad function pointer: GetWritableDataDirectory");
         throw bad_fptr("GetWritableDataDirectory");
     }
+    Activity activity("unitsync GetWritableDataDirectory");
     logger.debug("call GetWritableDataDirectory(", ")");
     return QString(fptr_GetWritableDataDirectory());
 }
@@ -640,6 +649,7 @@ int UnitsyncHandler::getDataDirectoryCount() {
         logger.error("Bad function pointer: GetDataDirectoryCount");
         throw bad_fptr("GetDataDirectoryCount");
     }
+    Activity activity("unitsync GetDataDirectoryCount");
     logger.debug("call GetDataDirectoryCount(", ")");
     return fptr_GetDataDirectoryCount();
 }
@@ -648,6 +658,7 @@ QString UnitsyncHandler::getDataDirectory(int index) {
         logger.error("Bad function pointer: GetDataDirectory");
         throw bad_fptr("GetDataDirectory");
     }
+    Activity activity("unitsync GetDataDirectory");
     logger.debug("call GetDataDirectory(", index, ")");
     return QString(fptr_GetDataDirectory(index));
 }
@@ -656,6 +667,7 @@ int UnitsyncHandler::processUnits() {
         logger.error("Bad function pointer: ProcessUnits");
         throw bad_fptr("ProcessUnits");
     }
+    Activity activity("unitsync ProcessUnits");
     logger.debug("call ProcessUnits(", ")");
     return fptr_ProcessUnits();
 }
@@ -664,6 +676,7 @@ int UnitsyncHandler::getUnitCount() {
         logger.error("Bad function pointer: GetUnitCount");
         throw bad_fptr("GetUnitCount");
     }
+    Activity activity("unitsync GetUnitCount");
     logger.debug("call GetUnitCount(", ")");
     return fptr_GetUnitCount();
 }
@@ -672,6 +685,7 @@ QString UnitsyncHandler::getUnitName(int unit) {
         logger.error("Bad function pointer: GetUnitName");
         throw bad_fptr("GetUnitName");
     }
+    Activity activity("unitsync GetUnitName");
     logger.debug("call GetUnitName(", unit, ")");
     return QString(fptr_GetUnitName(unit));
 }
@@ -680,6 +694,7 @@ QString UnitsyncHandler::getFullUnitName(int unit) {
         logger.error("Bad function pointer: GetFullUnitName");
         throw bad_fptr("GetFullUnitName");
     }
+    Activity activity("unitsync GetFullUnitName");
     logger.debug("call GetFullUnitName(", unit, ")");
     return QString(fptr_GetFullUnitName(unit));
 }
@@ -688,6 +703,7 @@ void UnitsyncHandler::addArchive(QString archiveName) {
         logger.error("Bad function pointer: AddArchive");
         throw bad_fptr("AddArchive");
     }
+    Activity activity("unitsync AddArchive");
     logger.debug("call AddArchive(", archiveName.toStdString().c_str(), ")");
     return fptr_AddArchive(archiveName.toStdString().c_str());
 }
@@ -696,6 +712,7 @@ void UnitsyncHandler::addAllArchives(QString rootArchiveName) {
         logger.error("Bad function pointer: AddAllArchives");
         throw bad_fptr("AddAllArchives");
     }
+    Activity activity("unitsync AddAllArchives");
     logger.debug("call AddAllArchives(", rootArchiveName.toStdString().c_str(), ")");
     return fptr_AddAllArchives(rootArchiveName.toStdString().c_str());
 }
@@ -704,6 +721,7 @@ void UnitsyncHandler::removeAllArchives() {
         logger.error("Bad function pointer: RemoveAllArchives");
         throw bad_fptr("RemoveAllArchives");
     }
+    Activity activity("unitsync RemoveAllArchives");
     logger.debug("call RemoveAllArchives(", ")");
     return fptr_RemoveAllArchives();
 }
@@ -712,6 +730,7 @@ int UnitsyncHandler::getArchiveChecksum(QString archiveName) {
         logger.error("Bad function pointer: GetArchiveChecksum");
         throw bad_fptr("GetArchiveChecksum");
     }
+    Activity activity("unitsync GetArchiveChecksum");
     logger.debug("call GetArchiveChecksum(", archiveName.toStdString().c_str(), ")");
     return fptr_GetArchiveChecksum(archiveName.toStdString().c_str());
 }
@@ -720,6 +739,7 @@ QString UnitsyncHandler::getArchivePath(QString archiveName) {
         logger.error("Bad function pointer: GetArchivePath");
         throw bad_fptr("GetArchivePath");
     }
+    Activity activity("unitsync GetArchivePath");
     logger.debug("call GetArchivePath(", archiveName.toStdString().c_str(), ")");
     return QString(fptr_GetArchivePath(archiveName.toStdString().c_str()));
 }
@@ -728,6 +748,7 @@ int UnitsyncHandler::getMapCount() {
         logger.error("Bad function pointer: GetMapCount");
         throw bad_fptr("GetMapCount");
     }
+    Activity activity("unitsync GetMapCount");
     logger.debug("call GetMapCount(", ")");
     return fptr_GetMapCount();
 }
@@ -736,6 +757,7 @@ QString UnitsyncHandler::getMapName(int index) {
         logger.error("Bad function pointer: GetMapName");
         throw bad_fptr("GetMapName");
     }
+    Activity activity("unitsync GetMapName");
     logger.debug("call GetMapName(", index, ")");
     return QString(fptr_GetMapName(index));
 }
@@ -744,6 +766,7 @@ QString UnitsyncHandler::getMapFileName(int index) {
         logger.error("Bad function pointer: GetMapFileName");
         throw bad_fptr("GetMapFileName");
     }
+    Activity activity("unitsync GetMapFileName");
     logger.debug("call GetMapFileName(", index, ")");
     return QString(fptr_GetMapFileName(index));
 }
@@ -752,6 +775,7 @@ QString UnitsyncHandler::getMapDescription(int index) {
         logger.error("Bad function pointer: GetMapDescription");
         throw bad_fptr("GetMapDescription");
     }
+    Activity activity("unitsync GetMapDescription");
     logger.debug("call GetMapDescription(", index, ")");
     return QString(fptr_GetMapDescription(index));
 }
@@ -760,6 +784,7 @@ QString UnitsyncHandler::getMapAuthor(int index) {
         logger.error("Bad function pointer: GetMapAuthor");
         throw bad_fptr("GetMapAuthor");
     }
+    Activity activity("unitsync GetMapAuthor");
     logger.debug("call GetMapAuthor(", index, ")");
     return QString(fptr_GetMapAuthor(index));
 }
@@ -768,6 +793,7 @@ int UnitsyncHandler::getMapWidth(int index) {
         logger.error("Bad function pointer: GetMapWidth");
         throw bad_fptr("GetMapWidth");
     }
+    Activity activity("unitsync GetMapWidth");
     logger.debug("call GetMapWidth(", index, ")");
     return fptr_GetMapWidth(index);
 }
@@ -776,6 +802,7 @@ int UnitsyncHandler::getMapHeight(int index) {
         logger.error("Bad function pointer: GetMapHeight");
         throw bad_fptr("GetMapHeight");
     }
+    Activity activity("unitsync GetMapHeight");
     logger.debug("call GetMapHeight(", index, ")");
     return fptr_GetMapHeight(index);
 }
@@ -784,6 +811,7 @@ int UnitsyncHandler::getMapTidalStrength(int index) {
         logger.error("Bad function pointer: GetMapTidalStrength");
         throw bad_fptr("GetMapTidalStrength");
     }
+    Activity activity("unitsync GetMapTidalStrength");
     logger.debug("call GetMapTidalStrength(", index, ")");
     return fptr_GetMapTidalStrength(index);
 }
@@ -792,6 +820,7 @@ int UnitsyncHandler::getMapWindMin(int index) {
         logger.error("Bad function pointer: GetMapWindMin");
         throw bad_fptr("GetMapWindMin");
     }
+    Activity activity("unitsync GetMapWindMin");
     logger.debug("call GetMapWindMin(", index, ")");
     return fptr_GetMapWindMin(index);
 }
@@ -800,6 +829,7 @@ int UnitsyncHandler::getMapWindMax(int index) {
         logger.error("Bad function pointer: GetMapWindMax");
         throw bad_fptr("GetMapWindMax");
     }
+    Activity activity("unitsync GetMapWindMax");
     logger.debug("call GetMapWindMax(", index, ")");
     return fptr_GetMapWindMax(index);
 }
@@ -808,6 +838,7 @@ int UnitsyncHandler::getMapGravity(int index) {
         logger.error("Bad function pointer: GetMapGravity");
         throw bad_fptr("GetMapGravity");
     }
+    Activity activity("unitsync GetMapGravity");
     logger.debug("call GetMapGravity(", index, ")");
     return fptr_GetMapGravity(index);
 }
@@ -816,6 +847,7 @@ int UnitsyncHandler::getMapResourceCount(int index) {
         logger.error("Bad function pointer: GetMapResourceCount");
         throw bad_fptr("GetMapResourceCount");
     }
+    Activity activity("unitsync GetMapResourceCount");
     logger.debug("call GetMapResourceCount(", index, ")");
     return fptr_GetMapResourceCount(index);
 }
@@ -824,6 +856,7 @@ QString UnitsyncHandler::getMapResourceName(int index, int resourceIndex) {
         logger.error("Bad function pointer: GetMapResourceName");
         throw bad_fptr("GetMapResourceName");
     }
+    Activity activity("unitsync GetMapResourceName");
     logger.debug("call GetMapResourceName(", index, ", ", resourceIndex, ")");
     return QString(fptr_GetMapResourceName(index, resourceIndex));
 }
@@ -832,6 +865,7 @@ float UnitsyncHandler::getMapResourceMax(int index, int resourceIndex) {
         logger.error("Bad function pointer: GetMapResourceMax");
         throw bad_fptr("GetMapResourceMax");
     }
+    Activity activity("unitsync GetMapResourceMax");
     logger.debug("call GetMapResourceMax(", index, ", ", resourceIndex, ")");
     return fptr_GetMapResourceMax(index, resourceIndex);
 }
@@ -840,6 +874,7 @@ int UnitsyncHandler::getMapResourceExtractorRadius(int index, int resourceIndex)
         logger.error("Bad function pointer: GetMapResourceExtractorRadius");
         throw bad_fptr("GetMapResourceExtractorRadius");
     }
+    Activity activity("unitsync GetMapResourceExtractorRadius");
     logger.debug("call GetMapResourceExtractorRadius(", index, ", ", resourceIndex, ")");
     return fptr_GetMapResourceExtractorRadius(index, resourceIndex);
 }
@@ -848,6 +883,7 @@ int UnitsyncHandler::getMapPosCount(int index) {
         logger.error("Bad function pointer: GetMapPosCount");
         throw bad_fptr("GetMapPosCount");
     }
+    Activity activity("unitsync GetMapPosCount");
     logger.debug("call GetMapPosCount(", index, ")");
     return fptr_GetMapPosCount(index);
 }
@@ -856,6 +892,7 @@ float UnitsyncHandler::getMapPosX(int index, int posIndex) {
         logger.error("Bad function pointer: GetMapPosX");
         throw bad_fptr("GetMapPosX");
     }
+    Activity activity("unitsync GetMapPosX");
     logger.debug("call GetMapPosX(", index, ", ", posIndex, ")");
     return fptr_GetMapPosX(index, posIndex);
 }
@@ -864,6 +901,7 @@ float UnitsyncHandler::getMapPosZ(int index, int posIndex) {
         logger.error("Bad function pointer: GetMapPosZ");
         throw bad_fptr("GetMapPosZ");
     }
+    Activity activity("unitsync GetMapPosZ");
     logger.debug("call GetMapPosZ(", index, ", ", posIndex, ")");
     return fptr_GetMapPosZ(index, posIndex);
 }
@@ -872,6 +910,7 @@ float UnitsyncHandler::getMapMinHeight(QString mapName) {
         logger.error("Bad function pointer: GetMapMinHeight");
         throw bad_fptr("GetMapMinHeight");
     }
+    Activity activity("unitsync GetMapMinHeight");
     logger.debug("call GetMapMinHeight(", mapName.toStdString().c_str(), ")");
     return fptr_GetMapMinHeight(mapName.toStdString().c_str());
 }
@@ -880,6 +919,7 @@ float UnitsyncHandler::getMapMaxHeight(QString mapName) {
         logger.error("Bad function pointer: GetMapMaxHeight");
         throw bad_fptr("GetMapMaxHeight");
     }
+    Activity activity("unitsync GetMapMaxHeight");
     logger.debug("call GetMapMaxHeight(", mapName.toStdString().c_str(), ")");
     return fptr_GetMapMaxHeight(mapName.toStdString().c_str());
 }
@@ -888,6 +928,7 @@ int UnitsyncHandler::getMapArchiveCount(QString mapName) {
         logger.error("Bad function pointer: GetMapArchiveCount");
         throw bad_fptr("GetMapArchiveCount");
     }
+    Activity activity("unitsync GetMapArchiveCount");
     logger.debug("call GetMapArchiveCount(", mapName.toStdString().c_str(), ")");
     return fptr_GetMapArchiveCount(mapName.toStdString().c_str());
 }
@@ -896,6 +937,7 @@ QString UnitsyncHandler::getMapArchiveName(int index) {
         logger.error("Bad function pointer: GetMapArchiveName");
         throw bad_fptr("GetMapArchiveName");
     }
+    Activity activity("unitsync GetMapArchiveName");
     logger.debug("call GetMapArchiveName(", index, ")");
     return QString(fptr_GetMapArchiveName(index));
 }
@@ -904,6 +946,7 @@ int UnitsyncHandler::getMapChecksum(int index) {
         logger.error("Bad function pointer: GetMapChecksum");
         throw bad_fptr("GetMapChecksum");
     }
+    Activity activity("unitsync GetMapChecksum");
     logger.debug("call GetMapChecksum(", index, ")");
     return fptr_GetMapChecksum(index);
 }
@@ -912,6 +955,7 @@ int UnitsyncHandler::getMapChecksumFromName(QString mapName) {
         logger.error("Bad function pointer: GetMapChecksumFromName");
         throw bad_fptr("GetMapChecksumFromName");
     }
+    Activity activity("unitsync GetMapChecksumFromName");
     logger.debug("call GetMapChecksumFromName(", mapName.toStdString().c_str(), ")");
     return fptr_GetMapChecksumFromName(mapName.toStdString().c_str());
 }
@@ -920,6 +964,7 @@ int UnitsyncHandler::getSkirmishAICount() {
         logger.error("Bad function pointer: GetSkirmishAICount");
         throw bad_fptr("GetSkirmishAICount");
     }
+    Activity activity("unitsync GetSkirmishAICount");
     logger.debug("call GetSkirmishAICount(", ")");
     return fptr_GetSkirmishAICount();
 }
@@ -928,6 +973,7 @@ int UnitsyncHandler::getSkirmishAIInfoCount(int index) {
         logger.error("Bad function pointer: GetSkirmishAIInfoCount");
         throw bad_fptr("GetSkirmishAIInfoCount");
     }
+    Activity activity("unitsync GetSkirmishAIInfoCount");
     logger.debug("call GetSkirmishAIInfoCount(", index, ")");
     return fptr_GetSkirmishAIInfoCount(index);
 }
@@ -936,6 +982,7 @@ QString UnitsyncHandler::getInfoKey(int index) {
         logger.error("Bad function pointer: GetInfoKey");
         throw bad_fptr("GetInfoKey");
     }
+    Activity activity("unitsync GetInfoKey");
     logger.debug("call GetInfoKey(", index, ")");
     return QString(fptr_GetInfoKey(index));
 }
@@ -944,6 +991,7 @@ QString UnitsyncHandler::getInfoType(int index) {
         logger.error("Bad function pointer: GetInfoType");
         throw bad_fptr("GetInfoType");
     }
+    Activity activity("unitsync GetInfoType");
     logger.debug("call GetInfoType(", index, ")");
     return QString(fptr_GetInfoType(index));
 }
@@ -952,6 +1000,7 @@ QString UnitsyncHandler::getInfoValueString(int index) {
         logger.error("Bad function pointer: GetInfoValueString");
         throw bad_fptr("GetInfoValueString");
     }
+    Activity activity("unitsync GetInfoValueString");
     logger.debug("call GetInfoValueString(", index, ")");
     return QString(fptr_GetInfoValueString(index));
 }
@@ -960,6 +1009,7 @@ int UnitsyncHandler::getInfoValueInteger(int index) {
         logger.error("Bad function pointer: GetInfoValueInteger");
         throw bad_fptr("GetInfoValueInteger");
     }
+    Activity activity("unitsync GetInfoValueInteger");
     logger.debug("call GetInfoValueInteger(", index, ")");
     return fptr_GetInfoValueInteger(index);
 }
@@ -968,6 +1018,7 @@ float UnitsyncHandler::getInfoValueFloat(int index) {
         logger.error("Bad function pointer: GetInfoValueFloat");
         throw bad_fptr("GetInfoValueFloat");
     }
+    Activity activity("unitsync GetInfoValueFloat");
     logger.debug("call GetInfoValueFloat(", index, ")");
     return fptr_GetInfoValueFloat(index);
 }
@@ -976,6 +1027,7 @@ bool UnitsyncHandler::getInfoValueBool(int index) {
         logger.error("Bad function pointer: GetInfoValueBool");
         throw bad_fptr("GetInfoValueBool");
     }
+    Activity activity("unitsync GetInfoValueBool");
     logger.debug("call GetInfoValueBool(", index, ")");
     return fptr_GetInfoValueBool(index);
 }
@@ -984,6 +1036,7 @@ QString UnitsyncHandler::getInfoDescription(int index) {
         logger.error("Bad function pointer: GetInfoDescription");
         throw bad_fptr("GetInfoDescription");
     }
+    Activity activity("unitsync GetInfoDescription");
     logger.debug("call GetInfoDescription(", index, ")");
     return QString(fptr_GetInfoDescription(index));
 }
@@ -992,6 +1045,7 @@ int UnitsyncHandler::getSkirmishAIOptionCount(int index) {
         logger.error("Bad function pointer: GetSkirmishAIOptionCount");
         throw bad_fptr("GetSkirmishAIOptionCount");
     }
+    Activity activity("unitsync GetSkirmishAIOptionCount");
     logger.debug("call GetSkirmishAIOptionCount(", index, ")");
     return fptr_GetSkirmishAIOptionCount(index);
 }
@@ -1000,6 +1054,7 @@ int UnitsyncHandler::getPrimaryModCount() {
         logger.error("Bad function pointer: GetPrimaryModCount");
         throw bad_fptr("GetPrimaryModCount");
     }
+    Activity activity("unitsync GetPrimaryModCount");
     logger.debug("call GetPrimaryModCount(", ")");
     return fptr_GetPrimaryModCount();
 }
@@ -1008,6 +1063,7 @@ int UnitsyncHandler::getPrimaryModInfoCount(int index) {
         logger.error("Bad function pointer: GetPrimaryModInfoCount");
         throw bad_fptr("GetPrimaryModInfoCount");
     }
+    Activity activity("unitsync GetPrimaryModInfoCount");
     logger.debug("call GetPrimaryModInfoCount(", index, ")");
     return fptr_GetPrimaryModInfoCount(index);
 }
@@ -1016,6 +1072,7 @@ QString UnitsyncHandler::getPrimaryModArchive(int index) {
         logger.error("Bad function pointer: GetPrimaryModArchive");
         throw bad_fptr("GetPrimaryModArchive");
     }
+    Activity activity("unitsync GetPrimaryModArchive");
     logger.debug("call GetPrimaryModArchive(", index, ")");
     return QString(fptr_GetPrimaryModArchive(index));
 }
@@ -1024,6 +1081,7 @@ int UnitsyncHandler::getPrimaryModArchiveCount(int index) {
         logger.error("Bad function pointer: GetPrimaryModArchiveCount");
         throw bad_fptr("GetPrimaryModArchiveCount");
     }
+    Activity activity("unitsync GetPrimaryModArchiveCount");
     logger.debug("call GetPrimaryModArchiveCount(", index, ")");
     return fptr_GetPrimaryModArchiveCount(index);
 }
@@ -1032,6 +1090,7 @@ QString UnitsyncHandler::getPrimaryModArchiveList(int archive) {
         logger.error("Bad function pointer: GetPrimaryModArchiveList");
         throw bad_fptr("GetPrimaryModArchiveList");
     }
+    Activity activity("unitsync GetPrimaryModArchiveList");
     logger.debug("call GetPrimaryModArchiveList(", archive, ")");
     return QString(fptr_GetPrimaryModArchiveList(archive));
 }
@@ -1040,6 +1099,7 @@ int UnitsyncHandler::getPrimaryModIndex(QString name) {
         logger.error("Bad function pointer: GetPrimaryModIndex");
         throw bad_fptr("GetPrimaryModIndex");
     }
+    Activity activity("unitsync GetPrimaryModIndex");
     logger.debug("call GetPrimaryModIndex(", name.toStdString().c_str(), ")");
     return fptr_GetPrimaryModIndex(name.toStdString().c_str());
 }
@@ -1048,6 +1108,7 @@ int UnitsyncHandler::getPrimaryModChecksum(int index) {
         logger.error("Bad function pointer: GetPrimaryModChecksum");
         throw bad_fptr("GetPrimaryModChecksum");
     }
+    Activity activity("unitsync GetPrimaryModChecksum");
     logger.debug("call GetPrimaryModChecksum(", index, ")");
     return fptr_GetPrimaryModChecksum(index);
 }
@@ -1056,6 +1117,7 @@ int UnitsyncHandler::getPrimaryModChecksumFromName(QString name) {
         logger.error("Bad function pointer: GetPrimaryModChecksumFromName");
         throw bad_fptr("GetPrimaryModChecksumFromName");
     }
+    Activity activity("unitsync GetPrimaryModChecksumFromName");
     logger.debug("call GetPrimaryModChecksumFromName(", name.toStdString().c_str(), ")");
     return fptr_GetPrimaryModChecksumFromName(name.toStdString().c_str());
 }
@@ -1064,6 +1126,7 @@ int UnitsyncHandler::getSideCount() {
         logger.error("Bad function pointer: GetSideCount");
         throw bad_fptr("GetSideCount");
     }
+    Activity activity("unitsync GetSideCount");
     logger.debug("call GetSideCount(", ")");
     return fptr_GetSideCount();
 }
@@ -1072,6 +1135,7 @@ QString UnitsyncHandler::getSideName(int side) {
         logger.error("Bad function pointer: GetSideName");
         throw bad_fptr("GetSideName");
     }
+    Activity activity("unitsync GetSideName");
     logger.debug("call GetSideName(", side, ")");
     return QString(fptr_GetSideName(side));
 }
@@ -1080,6 +1144,7 @@ QString UnitsyncHandler::getSideStartUnit(int side) {
         logger.error("Bad function pointer: GetSideStartUnit");
         throw bad_fptr("GetSideStartUnit");
     }
+    Activity activity("unitsync GetSideStartUnit");
     logger.debug("call GetSideStartUnit(", side, ")");
     return QString(fptr_GetSideStartUnit(side));
 }
@@ -1088,6 +1153,7 @@ int UnitsyncHandler::getMapOptionCount(QString mapName) {
         logger.error("Bad function pointer: GetMapOptionCount");
         throw bad_fptr("GetMapOptionCount");
     }
+    Activity activity("unitsync GetMapOptionCount");
     logger.debug("call GetMapOptionCount(", mapName.toStdString().c_str(), ")");
     return fptr_GetMapOptionCount(mapName.toStdString().c_str());
 }
@@ -1096,6 +1162,7 @@ int UnitsyncHandler::getModOptionCount() {
         logger.error("Bad function pointer: GetModOptionCount");
         throw bad_fptr("GetModOptionCount");
     }
+    Activity activity("unitsync GetModOptionCount");
     logger.debug("call GetModOptionCount(", ")");
     return fptr_GetModOptionCount();
 }
@@ -1104,6 +1171,7 @@ int UnitsyncHandler::getCustomOptionCount(QString fileName) {
         logger.error("Bad function pointer: GetCustomOptionCount");
         throw bad_fptr("GetCustomOptionCount");
     }
+    Activity activity("unitsync GetCustomOptionCount");
     logger.debug("call GetCustomOptionCount(", fileName.toStdString().c_str(), ")");
     return fptr_GetCustomOptionCount(fileName.toStdString().c_str());
 }
@@ -1112,6 +1180,7 @@ QString UnitsyncHandler::getOptionKey(int optIndex) {
         logger.error("Bad function pointer: GetOptionKey");
         throw bad_fptr("GetOptionKey");
     }
+    Activity activity("unitsync GetOptionKey");
     logger.debug("call GetOptionKey(", optIndex, ")");
     return QString(fptr_GetOptionKey(optIndex));
 }
@@ -1120,6 +1189,7 @@ QString UnitsyncHandler::getOptionScope(int optIndex) {
         logger.error("Bad function pointer: GetOptionScope");
         throw bad_fptr("GetOptionScope");
     }
+    Activity activity("unitsync GetOptionScope");
     logger.debug("call GetOptionScope(", optIndex, ")");
     return QString(fptr_GetOptionScope(optIndex));
 }
@@ -1128,6 +1198,7 @@ QString UnitsyncHandler::getOptionName(int optIndex) {
         logger.error("Bad function pointer: GetOptionName");
         throw bad_fptr("GetOptionName");
     }
+    Activity activity("unitsync GetOptionName");
     logger.debug("call GetOptionName(", optIndex, ")");
     return QString(fptr_GetOptionName(optIndex));
 }
@@ -1136,6 +1207,7 @@ QString UnitsyncHandler::getOptionSection(int optIndex) {
         logger.error("Bad function pointer: GetOptionSection");
         throw bad_fptr("GetOptionSection");
     }
+    Activity activity("unitsync GetOptionSection");
     logger.debug("call GetOptionSection(", optIndex, ")");
     return QString(fptr_GetOptionSection(optIndex));
 }
@@ -1144,6 +1216,7 @@ QString UnitsyncHandler::getOptionStyle(int optIndex) {
         logger.error("Bad function pointer: GetOptionStyle");
         throw bad_fptr("GetOptionStyle");
     }
+    Activity activity("unitsync GetOptionStyle");
     logger.debug("call GetOptionStyle(", optIndex, ")");
     return QString(fptr_GetOptionStyle(optIndex));
 }
@@ -1152,6 +1225,7 @@ QString UnitsyncHandler::getOptionDesc(int optIndex) {
         logger.error("Bad function pointer: GetOptionDesc");
         throw bad_fptr("GetOptionDesc");
     }
+    Activity activity("unitsync GetOptionDesc");
     logger.debug("call GetOptionDesc(", optIndex, ")");
     return QString(fptr_GetOptionDesc(optIndex));
 }
@@ -1160,6 +1234,7 @@ int UnitsyncHandler::getOptionType(int optIndex) {
         logger.error("Bad function pointer: GetOptionType");
         throw bad_fptr("GetOptionType");
     }
+    Activity activity("unitsync GetOptionType");
     logger.debug("call GetOptionType(", optIndex, ")");
     return fptr_GetOptionType(optIndex);
 }
@@ -1168,6 +1243,7 @@ int UnitsyncHandler::getOptionBoolDef(int optIndex) {
         logger.error("Bad function pointer: GetOptionBoolDef");
         throw bad_fptr("GetOptionBoolDef");
     }
+    Activity activity("unitsync GetOptionBoolDef");
     logger.debug("call GetOptionBoolDef(", optIndex, ")");
     return fptr_GetOptionBoolDef(optIndex);
 }
@@ -1176,6 +1252,7 @@ float UnitsyncHandler::getOptionNumberDef(int optIndex) {
         logger.error("Bad function pointer: GetOptionNumberDef");
         throw bad_fptr("GetOptionNumberDef");
     }
+    Activity activity("unitsync GetOptionNumberDef");
     logger.debug("call GetOptionNumberDef(", optIndex, ")");
     return fptr_GetOptionNumberDef(optIndex);
 }
@@ -1184,6 +1261,7 @@ float UnitsyncHandler::getOptionNumberMin(int optIndex) {
         logger.error("Bad function pointer: GetOptionNumberMin");
         throw bad_fptr("GetOptionNumberMin");
     }
+    Activity activity("unitsync GetOptionNumberMin");
     logger.debug("call GetOptionNumberMin(", optIndex, ")");
     return fptr_GetOptionNumberMin(optIndex);
 }
@@ -1192,6 +1270,7 @@ float UnitsyncHandler::getOptionNumberMax(int optIndex) {
         logger.error("Bad function pointer: GetOptionNumberMax");
         throw bad_fptr("GetOptionNumberMax");
     }
+    Activity activity("unitsync GetOptionNumberMax");
     logger.debug("call GetOptionNumberMax(", optIndex, ")");
     return fptr_GetOptionNumberMax(optIndex);
 }
@@ -1200,6 +1279,7 @@ float UnitsyncHandler::getOptionNumberStep(int optIndex) {
         logger.error("Bad function pointer: GetOptionNumberStep");
         throw bad_fptr("GetOptionNumberStep");
     }
+    Activity activity("unitsync GetOptionNumberStep");
     logger.debug("call GetOptionNumberStep(", optIndex, ")");
     return fptr_GetOptionNumberStep(optIndex);
 }
@@ -1208,6 +1288,7 @@ QString UnitsyncHandler::getOptionStringDef(int optIndex) {
         logger.error("Bad function pointer: GetOptionStringDef");
         throw bad_fptr("GetOptionStringDef");
     }
+    Activity activity("unitsync GetOptionStringDef");
     logger.debug("call GetOptionStringDef(", optIndex, ")");
     return QString(fptr_GetOptionStringDef(optIndex));
 }
@@ -1216,6 +1297,7 @@ int UnitsyncHandler::getOptionStringMaxLen(int optIndex) {
         logger.error("Bad function pointer: GetOptionStringMaxLen");
         throw bad_fptr("GetOptionStringMaxLen");
     }
+    Activity activity("unitsync GetOptionStringMaxLen");
     logger.debug("call GetOptionStringMaxLen(", optIndex, ")");
     return fptr_GetOptionStringMaxLen(optIndex);
 }
@@ -1224,6 +1306,7 @@ int UnitsyncHandler::getOptionListCount(int optIndex) {
         logger.error("Bad function pointer: GetOptionListCount");
         throw bad_fptr("GetOptionListCount");
     }
+    Activity activity("unitsync GetOptionListCount");
     logger.debug("call GetOptionListCount(", optIndex, ")");
     return fptr_GetOptionListCount(optIndex);
 }
@@ -1232,6 +1315,7 @@ QString UnitsyncHandler::getOptionListDef(int optIndex) {
         logger.error("Bad function pointer: GetOptionListDef");
         throw bad_fptr("GetOptionListDef");
     }
+    Activity activity("unitsync GetOptionListDef");
     logger.debug("call GetOptionListDef(", optIndex, ")");
     return QString(fptr_GetOptionListDef(optIndex));
 }
@@ -1240,6 +1324,7 @@ QString UnitsyncHandler::getOptionListItemKey(int optIndex, int itemIndex) {
         logger.error("Bad function pointer: GetOptionListItemKey");
         throw bad_fptr("GetOptionListItemKey");
     }
+    Activity activity("unitsync GetOptionListItemKey");
     logger.debug("call GetOptionListItemKey(", optIndex, ", ", itemIndex, ")");
     return QString(fptr_GetOptionListItemKey(optIndex, itemIndex));
 }
@@ -1248,6 +1333,7 @@ QString UnitsyncHandler::getOptionListItemName(int optIndex, int itemIndex) {
         logger.error("Bad function pointer: GetOptionListItemName");
         throw bad_fptr("GetOptionListItemName");
     }
+    Activity activity("unitsync GetOptionListItemName");
     logger.debug("call GetOptionListItemName(", optIndex, ", ", itemIndex, ")");
     return QString(fptr_GetOptionListItemName(optIndex, itemIndex));
 }
@@ -1256,6 +1342,7 @@ QString UnitsyncHandler::getOptionListItemDesc(int optIndex, int itemIndex) {
         logger.error("Bad function pointer: GetOptionListItemDesc");
         throw bad_fptr("GetOptionListItemDesc");
     }
+    Activity activity("unitsync GetOptionListItemDesc");
     logger.debug("call GetOptionListItemDesc(", optIndex, ", ", itemIndex, ")");
     return QString(fptr_GetOptionListItemDesc(optIndex, itemIndex));
 }
@@ -1264,6 +1351,7 @@ int UnitsyncHandler::getModValidMapCount() {
         logger.error("Bad function pointer: GetModValidMapCount");
         throw bad_fptr("GetModValidMapCount");
     }
+    Activity activity("unitsync GetModValidMapCount");
     logger.debug("call GetModValidMapCount(", ")");
     return fptr_GetModValidMapCount();
 }
@@ -1272,6 +1360,7 @@ QString UnitsyncHandler::getModValidMap(int index) {
         logger.error("Bad function pointer: GetModValidMap");
         throw bad_fptr("GetModValidMap");
     }
+    Activity activity("unitsync GetModValidMap");
     logger.debug("call GetModValidMap(", index, ")");
     return QString(fptr_GetModValidMap(index));
 }
@@ -1280,6 +1369,7 @@ int UnitsyncHandler::openFileVFS(QString name) {
         logger.error("Bad function pointer: OpenFileVFS");
         throw bad_fptr("OpenFileVFS");
     }
+    Activity activity("unitsync OpenFileVFS");
     logger.debug("call OpenFileVFS(", name.toStdString().c_str(), ")");
     return fptr_OpenFileVFS(name.toStdString().c_str());
 }
@@ -1288,6 +1378,7 @@ void UnitsyncHandler::closeFileVFS(int file) {
         logger.error("Bad function pointer: CloseFileVFS");
         throw bad_fptr("CloseFileVFS");
     }
+    Activity activity("unitsync CloseFileVFS");
     logger.debug("call CloseFileVFS(", file, ")");
     return fptr_CloseFileVFS(file);
 }
@@ -1296,6 +1387,7 @@ int UnitsyncHandler::fileSizeVFS(int file) {
         logger.error("Bad function pointer: FileSizeVFS");
         throw bad_fptr("FileSizeVFS");
     }
+    Activity activity("unitsync FileSizeVFS");
     logger.debug("call FileSizeVFS(", file, ")");
     return fptr_FileSizeVFS(file);
 }
@@ -1304,6 +1396,7 @@ int UnitsyncHandler::initFindVFS(QString pattern) {
         logger.error("Bad function pointer: InitFindVFS");
         throw bad_fptr("InitFindVFS");
     }
+    Activity activity("unitsync InitFindVFS");
     logger.debug("call InitFindVFS(", pattern.toStdString().c_str(), ")");
     return fptr_InitFindVFS(pattern.toStdString().c_str());
 }
@@ -1312,6 +1405,7 @@ int UnitsyncHandler::initDirListVFS(QString path, QString pattern, QString modes
         logger.error("Bad function pointer: InitDirListVFS");
         throw bad_fptr("InitDirListVFS");
     }
+    Activity activity("unitsync InitDirListVFS");
     logger.debug("call InitDirListVFS(", path.toStdString().c_str(), ", ", pattern.toStdString().c_str(), ", ", modes.toStdString().c_str(), ")");
     return fptr_InitDirListVFS(path.toStdString().c_str(), pattern.toStdString().c_str(), modes.toStdString().c_str());
 }
@@ -1320,6 +1414,7 @@ int UnitsyncHandler::initSubDirsVFS(QString path, QString pattern, QString modes
         logger.error("Bad function pointer: InitSubDirsVFS");
         throw bad_fptr("InitSubDirsVFS");
     }
+    Activity activity("unitsync InitSubDirsVFS");
     logger.debug("call InitSubDirsVFS(", path.toStdString().c_str(), ", ", pattern.toStdString().c_str(), ", ", modes.toStdString().c_str(), ")");
     return fptr_InitSubDirsVFS(path.toStdString().c_str(), pattern.toStdString().c_str(), modes.toStdString().c_str());
 }
@@ -1328,6 +1423,7 @@ int UnitsyncHandler::openArchive(QString name) {
         logger.error("Bad function pointer: OpenArchive");
         throw bad_fptr("OpenArchive");
     }
+    Activity activity("unitsync OpenArchive");
     logger.debug("call OpenArchive(", name.toStdString().c_str(), ")");
     return fptr_OpenArchive(name.toStdString().c_str());
 }
@@ -1336,6 +1432,7 @@ void UnitsyncHandler::closeArchive(int archive) {
         logger.error("Bad function pointer: CloseArchive");
         throw bad_fptr("CloseArchive");
     }
+    Activity activity("unitsync CloseArchive");
     logger.debug("call CloseArchive(", archive, ")");
     return fptr_CloseArchive(archive);
 }
@@ -1344,6 +1441,7 @@ int UnitsyncHandler::openArchiveFile(int archive, QString name) {
         logger.error("Bad function pointer: OpenArchiveFile");
         throw bad_fptr("OpenArchiveFile");
     }
+    Activity activity("unitsync OpenArchiveFile");
     logger.debug("call OpenArchiveFile(", archive, ", ", name.toStdString().c_str(), ")");
     return fptr_OpenArchiveFile(archive, name.toStdString().c_str());
 }
@@ -1352,6 +1450,7 @@ void UnitsyncHandler::closeArchiveFile(int archive, int file) {
         logger.error("Bad function pointer: CloseArchiveFile");
         throw bad_fptr("CloseArchiveFile");
     }
+    Activity activity("unitsync CloseArchiveFile");
     logger.debug("call CloseArchiveFile(", archive, ", ", file, ")");
     return fptr_CloseArchiveFile(archive, file);
 }
@@ -1360,6 +1459,7 @@ int UnitsyncHandler::sizeArchiveFile(int archive, int file) {
         logger.error("Bad function pointer: SizeArchiveFile");
         throw bad_fptr("SizeArchiveFile");
     }
+    Activity activity("unitsync SizeArchiveFile");
     logger.debug("call SizeArchiveFile(", archive, ", ", file, ")");
     return fptr_SizeArchiveFile(archive, file);
 }
@@ -1368,6 +1468,7 @@ void UnitsyncHandler::setSpringConfigFile(QString fileNameAsAbsolutePath) {
         logger.error("Bad function pointer: SetSpringConfigFile");
         throw bad_fptr("SetSpringConfigFile");
     }
+    Activity activity("unitsync SetSpringConfigFile");
     logger.debug("call SetSpringConfigFile(", fileNameAsAbsolutePath.toStdString().c_str(), ")");
     return fptr_SetSpringConfigFile(fileNameAsAbsolutePath.toStdString().c_str());
 }
@@ -1376,6 +1477,7 @@ QString UnitsyncHandler::getSpringConfigFile() {
         logger.error("Bad function pointer: GetSpringConfigFile");
         throw bad_fptr("GetSpringConfigFile");
     }
+    Activity activity("unitsync GetSpringConfigFile");
     logger.debug("call GetSpringConfigFile(", ")");
     return QString(fptr_GetSpringConfigFile());
 }
@@ -1384,6 +1486,7 @@ QString UnitsyncHandler::getSpringConfigString(QString name, QString defValue) {
         logger.error("Bad function pointer: GetSpringConfigString");
         throw bad_fptr("GetSpringConfigString");
     }
+    Activity activity("unitsync GetSpringConfigString");
     logger.debug("call GetSpringConfigString(", name.toStdString().c_str(), ", ", defValue.toStdString().c_str(), ")");
     return QString(fptr_GetSpringConfigString(name.toStdString().c_str(), defValue.toStdString().c_str()));
 }
@@ -1392,6 +1495,7 @@ int UnitsyncHandler::getSpringConfigInt(QString name, int defValue) {
         logger.error("Bad function pointer: GetSpringConfigInt");
         throw bad_fptr("GetSpringConfigInt");
     }
+    Activity activity("unitsync GetSpringConfigInt");
     logger.debug("call GetSpringConfigInt(", name.toStdString().c_str(), ", ", defValue, ")");
     return fptr_GetSpringConfigInt(name.toStdString().c_str(), defValue);
 }
@@ -1400,6 +1504,7 @@ float UnitsyncHandler::getSpringConfigFloat(QString name, float defValue) {
         logger.error("Bad function pointer: GetSpringConfigFloat");
         throw bad_fptr("GetSpringConfigFloat");
     }
+    Activity activity("unitsync GetSpringConfigFloat");
     logger.debug("call GetSpringConfigFloat(", name.toStdString().c_str(), ", ", defValue, ")");
     return fptr_GetSpringConfigFloat(name.toStdString().c_str(), defValue);
 }
@@ -1408,6 +1513,7 @@ void UnitsyncHandler::setSpringConfigString(QString name, QString value) {
         logger.error("Bad function pointer: SetSpringConfigString");
         throw bad_fptr("SetSpringConfigString");
     }
+    Activity activity("unitsync SetSpringConfigString");
     logger.debug("call SetSpringConfigString(", name.toStdString().c_str(), ", ", value.toStdString().c_str(), ")");
     return fptr_SetSpringConfigString(name.toStdString().c_str(), value.toStdString().c_str());
 }
@@ -1416,6 +1522,7 @@ void UnitsyncHandler::setSpringConfigInt(QString name, int value) {
         logger.error("Bad function pointer: SetSpringConfigInt");
         throw bad_fptr("SetSpringConfigInt");
     }
+    Activity activity("unitsync SetSpringConfigInt");
     logger.debug("call SetSpringConfigInt(", name.toStdString().c_str(), ", ", value, ")");
     return fptr_SetSpringConfigInt(name.toStdString().c_str(), value);
 }
@@ -1424,6 +1531,7 @@ void UnitsyncHandler::setSpringConfigFloat(QString name, float value) {
         logger.error("Bad function pointer: SetSpringConfigFloat");
         throw bad_fptr("SetSpringConfigFloat");
     }
+    Activity activity("unitsync SetSpringConfigFloat");
     logger.debug("call SetSpringConfigFloat(", name.toStdString().c_str(), ", ", value, ")");
     return fptr_SetSpringConfigFloat(name.toStdString().c_str(), value);
 }
@@ -1432,6 +1540,7 @@ void UnitsyncHandler::deleteSpringConfigKey(QString name) {
         logger.error("Bad function pointer: DeleteSpringConfigKey");
         throw bad_fptr("DeleteSpringConfigKey");
     }
+    Activity activity("unitsync DeleteSpringConfigKey");
     logger.debug("call DeleteSpringConfigKey(", name.toStdString().c_str(), ")");
     return fptr_DeleteSpringConfigKey(name.toStdString().c_str());
 }
@@ -1440,6 +1549,7 @@ void UnitsyncHandler::lpClose() {
         logger.error("Bad function pointer: lpClose");
         throw bad_fptr("lpClose");
     }
+    Activity activity("unitsync lpClose");
     logger.debug("call lpClose(", ")");
     return fptr_lpClose();
 }
@@ -1448,6 +1558,7 @@ int UnitsyncHandler::lpOpenFile(QString fileName, QString fileModes, QString acc
         logger.error("Bad function pointer: lpOpenFile");
         throw bad_fptr("lpOpenFile");
     }
+    Activity activity("unitsync lpOpenFile");
     logger.debug("call lpOpenFile(", fileName.toStdString().c_str(), ", ", fileModes.toStdString().c_str(), ", ", accessModes.toStdString().c_str(), ")");
     return fptr_lpOpenFile(fileName.toStdString().c_str(), fileModes.toStdString().c_str(), accessModes.toStdString().c_str());
 }
@@ -1456,6 +1567,7 @@ int UnitsyncHandler::lpOpenSource(QString source, QString accessModes) {
         logger.error("Bad function pointer: lpOpenSource");
         throw bad_fptr("lpOpenSource");
     }
+    Activity activity("unitsync lpOpenSource");
     logger.debug("call lpOpenSource(", source.toStdString().c_str(), ", ", accessModes.toStdString().c_str(), ")");
     return fptr_lpOpenSource(source.toStdString().c_str(), accessModes.toStdString().c_str());
 }
@@ -1464,6 +1576,7 @@ int UnitsyncHandler::lpExecute() {
         logger.error("Bad function pointer: lpExecute");
         throw bad_fptr("lpExecute");
     }
+    Activity activity("unitsync lpExecute");
     logger.debug("call lpExecute(", ")");
     return fptr_lpExecute();
 }
@@ -1472,6 +1585,7 @@ QString UnitsyncHandler::lpErrorLog() {
         logger.error("Bad function pointer: lpErrorLog");
         throw bad_fptr("lpErrorLog");
     }
+    Activity activity("unitsync lpErrorLog");
     logger.debug("call lpErrorLog(", ")");
     return QString(fptr_lpErrorLog());
 }
@@ -1480,6 +1594,7 @@ void UnitsyncHandler::lpAddTableInt(int key, int override) {
         logger.error("Bad function pointer: lpAddTableInt");
         throw bad_fptr("lpAddTableInt");
     }
+    Activity activity("unitsync lpAddTableInt");
     logger.debug("call lpAddTableInt(", key, ", ", override, ")");
     return fptr_lpAddTableInt(key, override);
 }
@@ -1488,6 +1603,7 @@ void UnitsyncHandler::lpAddTableStr(QString key, int override) {
         logger.error("Bad function pointer: lpAddTableStr");
         throw bad_fptr("lpAddTableStr");
     }
+    Activity activity("unitsync lpAddTableStr");
     logger.debug("call lpAddTableStr(", key.toStdString().c_str(), ", ", override, ")");
     return fptr_lpAddTableStr(key.toStdString().c_str(), override);
 }
@@ -1496,6 +1612,7 @@ void UnitsyncHandler::lpEndTable() {
         logger.error("Bad function pointer: lpEndTable");
         throw bad_fptr("lpEndTable");
     }
+    Activity activity("unitsync lpEndTable");
     logger.debug("call lpEndTable(", ")");
     return fptr_lpEndTable();
 }
@@ -1504,6 +1621,7 @@ void UnitsyncHandler::lpAddIntKeyIntVal(int key, int value) {
         logger.error("Bad function pointer: lpAddIntKeyIntVal");
         throw bad_fptr("lpAddIntKeyIntVal");
     }
+    Activity activity("unitsync lpAddIntKeyIntVal");
     logger.debug("call lpAddIntKeyIntVal(", key, ", ", value, ")");
     return fptr_lpAddIntKeyIntVal(key, value);
 }
@@ -1512,6 +1630,7 @@ void UnitsyncHandler::lpAddStrKeyIntVal(QString key, int value) {
         logger.error("Bad function pointer: lpAddStrKeyIntVal");
         throw bad_fptr("lpAddStrKeyIntVal");
     }
+    Activity activity("unitsync lpAddStrKeyIntVal");
     logger.debug("call lpAddStrKeyIntVal(", key.toStdString().c_str(), ", ", value, ")");
     return fptr_lpAddStrKeyIntVal(key.toStdString().c_str(), value);
 }
@@ -1520,6 +1639,7 @@ void UnitsyncHandler::lpAddIntKeyBoolVal(int key, int value) {
         logger.error("Bad function pointer: lpAddIntKeyBoolVal");
         throw bad_fptr("lpAddIntKeyBoolVal");
     }
+    Activity activity("unitsync lpAddIntKeyBoolVal");
     logger.debug("call lpAddIntKeyBoolVal(", key, ", ", value, ")");
     return fptr_lpAddIntKeyBoolVal(key, value);
 }
@@ -1528,6 +1648,7 @@ void UnitsyncHandler::lpAddStrKeyBoolVal(QString key, int value) {
         logger.error("Bad function pointer: lpAddStrKeyBoolVal");
         throw bad_fptr("lpAddStrKeyBoolVal");
     }
+    Activity activity("unitsync lpAddStrKeyBoolVal");
     logger.debug("call lpAddStrKeyBoolVal(", key.toStdString().c_str(), ", ", value, ")");
     return fptr_lpAddStrKeyBoolVal(key.toStdString().c_str(), value);
 }
@@ -1536,6 +1657,7 @@ void UnitsyncHandler::lpAddIntKeyFloatVal(int key, float value) {
         logger.error("Bad function pointer: lpAddIntKeyFloatVal");
         throw bad_fptr("lpAddIntKeyFloatVal");
     }
+    Activity activity("unitsync lpAddIntKeyFloatVal");
     logger.debug("call lpAddIntKeyFloatVal(", key, ", ", value, ")");
     return fptr_lpAddIntKeyFloatVal(key, value);
 }
@@ -1544,6 +1666,7 @@ void UnitsyncHandler::lpAddStrKeyFloatVal(QString key, float value) {
         logger.error("Bad function pointer: lpAddStrKeyFloatVal");
         throw bad_fptr("lpAddStrKeyFloatVal");
     }
+    Activity activity("unitsync lpAddStrKeyFloatVal");
     logger.debug("call lpAddStrKeyFloatVal(", key.toStdString().c_str(), ", ", value, ")");
     return fptr_lpAddStrKeyFloatVal(key.toStdString().c_str(), value);
 }
@@ -1552,6 +1675,7 @@ void UnitsyncHandler::lpAddIntKeyStrVal(int key, QString value) {
         logger.error("Bad function pointer: lpAddIntKeyStrVal");
         throw bad_fptr("lpAddIntKeyStrVal");
     }
+    Activity activity("unitsync lpAddIntKeyStrVal");
     logger.debug("call lpAddIntKeyStrVal(", key, ", ", value.toStdString().c_str(), ")");
     return fptr_lpAddIntKeyStrVal(key, value.toStdString().c_str());
 }
@@ -1560,6 +1684,7 @@ void UnitsyncHandler::lpAddStrKeyStrVal(QString key, QString value) {
         logger.error("Bad function pointer: lpAddStrKeyStrVal");
         throw bad_fptr("lpAddStrKeyStrVal");
     }
+    Activity activity("unitsync lpAddStrKeyStrVal");
     logger.debug("call lpAddStrKeyStrVal(", key.toStdString().c_str(), ", ", value.toStdString().c_str(), ")");
     return fptr_lpAddStrKeyStrVal(key.toStdString().c_str(), value.toStdString().c_str());
 }
@@ -1568,6 +1693,7 @@ int UnitsyncHandler::lpRootTable() {
         logger.error("Bad function pointer: lpRootTable");
         throw bad_fptr("lpRootTable");
     }
+    Activity activity("unitsync lpRootTable");
     logger.debug("call lpRootTable(", ")");
     return fptr_lpRootTable();
 }
@@ -1576,6 +1702,7 @@ int UnitsyncHandler::lpRootTableExpr(QString expr) {
         logger.error("Bad function pointer: lpRootTableExpr");
         throw bad_fptr("lpRootTableExpr");
     }
+    Activity activity("unitsync lpRootTableExpr");
     logger.debug("call lpRootTableExpr(", expr.toStdString().c_str(), ")");
     return fptr_lpRootTableExpr(expr.toStdString().c_str());
 }
@@ -1584,6 +1711,7 @@ int UnitsyncHandler::lpSubTableInt(int key) {
         logger.error("Bad function pointer: lpSubTableInt");
         throw bad_fptr("lpSubTableInt");
     }
+    Activity activity("unitsync lpSubTableInt");
     logger.debug("call lpSubTableInt(", key, ")");
     return fptr_lpSubTableInt(key);
 }
@@ -1592,6 +1720,7 @@ int UnitsyncHandler::lpSubTableStr(QString key) {
         logger.error("Bad function pointer: lpSubTableStr");
         throw bad_fptr("lpSubTableStr");
     }
+    Activity activity("unitsync lpSubTableStr");
     logger.debug("call lpSubTableStr(", key.toStdString().c_str(), ")");
     return fptr_lpSubTableStr(key.toStdString().c_str());
 }
@@ -1600,6 +1729,7 @@ int UnitsyncHandler::lpSubTableExpr(QString expr) {
         logger.error("Bad function pointer: lpSubTableExpr");
         throw bad_fptr("lpSubTableExpr");
     }
+    Activity activity("unitsync lpSubTableExpr");
     logger.debug("call lpSubTableExpr(", expr.toStdString().c_str(), ")");
     return fptr_lpSubTableExpr(expr.toStdString().c_str());
 }
@@ -1608,6 +1738,7 @@ void UnitsyncHandler::lpPopTable() {
         logger.error("Bad function pointer: lpPopTable");
         throw bad_fptr("lpPopTable");
     }
+    Activity activity("unitsync lpPopTable");
     logger.debug("call lpPopTable(", ")");
     return fptr_lpPopTable();
 }
@@ -1616,6 +1747,7 @@ int UnitsyncHandler::lpGetKeyExistsInt(int key) {
         logger.error("Bad function pointer: lpGetKeyExistsInt");
         throw bad_fptr("lpGetKeyExistsInt");
     }
+    Activity activity("unitsync lpGetKeyExistsInt");
     logger.debug("call lpGetKeyExistsInt(", key, ")");
     return fptr_lpGetKeyExistsInt(key);
 }
@@ -1624,6 +1756,7 @@ int UnitsyncHandler::lpGetKeyExistsStr(QString key) {
         logger.error("Bad function pointer: lpGetKeyExistsStr");
         throw bad_fptr("lpGetKeyExistsStr");
     }
+    Activity activity("unitsync lpGetKeyExistsStr");
     logger.debug("call lpGetKeyExistsStr(", key.toStdString().c_str(), ")");
     return fptr_lpGetKeyExistsStr(key.toStdString().c_str());
 }
@@ -1632,6 +1765,7 @@ int UnitsyncHandler::lpGetIntKeyType(int key) {
         logger.error("Bad function pointer: lpGetIntKeyType");
         throw bad_fptr("lpGetIntKeyType");
     }
+    Activity activity("unitsync lpGetIntKeyType");
     logger.debug("call lpGetIntKeyType(", key, ")");
     return fptr_lpGetIntKeyType(key);
 }
@@ -1640,6 +1774,7 @@ int UnitsyncHandler::lpGetStrKeyType(QString key) {
         logger.error("Bad function pointer: lpGetStrKeyType");
         throw bad_fptr("lpGetStrKeyType");
     }
+    Activity activity("unitsync lpGetStrKeyType");
     logger.debug("call lpGetStrKeyType(", key.toStdString().c_str(), ")");
     return fptr_lpGetStrKeyType(key.toStdString().c_str());
 }
@@ -1648,6 +1783,7 @@ int UnitsyncHandler::lpGetIntKeyListCount() {
         logger.error("Bad function pointer: lpGetIntKeyListCount");
         throw bad_fptr("lpGetIntKeyListCount");
     }
+    Activity activity("unitsync lpGetIntKeyListCount");
     logger.debug("call lpGetIntKeyListCount(", ")");
     return fptr_lpGetIntKeyListCount();
 }
@@ -1656,6 +1792,7 @@ int UnitsyncHandler::lpGetIntKeyListEntry(int index) {
         logger.error("Bad function pointer: lpGetIntKeyListEntry");
         throw bad_fptr("lpGetIntKeyListEntry");
     }
+    Activity activity("unitsync lpGetIntKeyListEntry");
     logger.debug("call lpGetIntKeyListEntry(", index, ")");
     return fptr_lpGetIntKeyListEntry(index);
 }
@@ -1664,6 +1801,7 @@ int UnitsyncHandler::lpGetStrKeyListCount() {
         logger.error("Bad function pointer: lpGetStrKeyListCount");
         throw bad_fptr("lpGetStrKeyListCount");
     }
+    Activity activity("unitsync lpGetStrKeyListCount");
     logger.debug("call lpGetStrKeyListCount(", ")");
     return fptr_lpGetStrKeyListCount();
 }
@@ -1672,6 +1810,7 @@ QString UnitsyncHandler::lpGetStrKeyListEntry(int index) {
         logger.error("Bad function pointer: lpGetStrKeyListEntry");
         throw bad_fptr("lpGetStrKeyListEntry");
     }
+    Activity activity("unitsync lpGetStrKeyListEntry");
     logger.debug("call lpGetStrKeyListEntry(", index, ")");
     return QString(fptr_lpGetStrKeyListEntry(index));
 }
@@ -1680,6 +1819,7 @@ int UnitsyncHandler::lpGetIntKeyIntVal(int key, int defValue) {
         logger.error("Bad function pointer: lpGetIntKeyIntVal");
         throw bad_fptr("lpGetIntKeyIntVal");
     }
+    Activity activity("unitsync lpGetIntKeyIntVal");
     logger.debug("call lpGetIntKeyIntVal(", key, ", ", defValue, ")");
     return fptr_lpGetIntKeyIntVal(key, defValue);
 }
@@ -1688,6 +1828,7 @@ int UnitsyncHandler::lpGetStrKeyIntVal(QString key, int defValue) {
         logger.error("Bad function pointer: lpGetStrKeyIntVal");
         throw bad_fptr("lpGetStrKeyIntVal");
     }
+    Activity activity("unitsync lpGetStrKeyIntVal");
     logger.debug("call lpGetStrKeyIntVal(", key.toStdString().c_str(), ", ", defValue, ")");
     return fptr_lpGetStrKeyIntVal(key.toStdString().c_str(), defValue);
 }
@@ -1696,6 +1837,7 @@ int UnitsyncHandler::lpGetIntKeyBoolVal(int key, int defValue) {
         logger.error("Bad function pointer: lpGetIntKeyBoolVal");
         throw bad_fptr("lpGetIntKeyBoolVal");
     }
+    Activity activity("unitsync lpGetIntKeyBoolVal");
     logger.debug("call lpGetIntKeyBoolVal(", key, ", ", defValue, ")");
     return fptr_lpGetIntKeyBoolVal(key, defValue);
 }
@@ -1704,6 +1846,7 @@ int UnitsyncHandler::lpGetStrKeyBoolVal(QString key, int defValue) {
         logger.error("Bad function pointer: lpGetStrKeyBoolVal");
         throw bad_fptr("lpGetStrKeyBoolVal");
     }
+    Activity activity("unitsync lpGetStrKeyBoolVal");
     logger.debug("call lpGetStrKeyBoolVal(", key.toStdString().c_str(), ", ", defValue, ")");
     return fptr_lpGetStrKeyBoolVal(key.toStdString().c_str(), defValue);
 }
@@ -1712,6 +1855,7 @@ float UnitsyncHandler::lpGetIntKeyFloatVal(int key, float defValue) {
         logger.error("Bad function pointer: lpGetIntKeyFloatVal");
         throw bad_fptr("lpGetIntKeyFloatVal");
     }
+    Activity activity("unitsync lpGetIntKeyFloatVal");
     logger.debug("call lpGetIntKeyFloatVal(", key, ", ", defValue, ")");
     return fptr_lpGetIntKeyFloatVal(key, defValue);
 }
@@ -1720,6 +1864,7 @@ float UnitsyncHandler::lpGetStrKeyFloatVal(QString key, float defValue) {
         logger.error("Bad function pointer: lpGetStrKeyFloatVal");
         throw bad_fptr("lpGetStrKeyFloatVal");
     }
+    Activity activity("unitsync lpGetStrKeyFloatVal");
     logger.debug("call lpGetStrKeyFloatVal(", key.toStdString().c_str(), ", ", defValue, ")");
     return fptr_lpGetStrKeyFloatVal(key.toStdString().c_str(), defValue);
 }
@@ -1728,6 +1873,7 @@ QString UnitsyncHandler::lpGetIntKeyStrVal(int key, QString defValue) {
         logger.error("Bad function pointer: lpGetIntKeyStrVal");
         throw bad_fptr("lpGetIntKeyStrVal");
     }
+    Activity activity("unitsync lpGetIntKeyStrVal");
     logger.debug("call lpGetIntKeyStrVal(", key, ", ", defValue.toStdString().c_str(), ")");
     return QString(fptr_lpGetIntKeyStrVal(key, defValue.toStdString().c_str()));
 }
@@ -1736,6 +1882,7 @@ QString UnitsyncHandler::lpGetStrKeyStrVal(QString key, QString defValue) {
         logger.error("Bad function pointer: lpGetStrKeyStrVal");
         throw bad_fptr("lpGetStrKeyStrVal");
     }
+    Activity activity("unitsync lpGetStrKeyStrVal");
     logger.debug("call lpGetStrKeyStrVal(", key.toStdString().c_str(), ", ", defValue.toStdString().c_str(), ")");
     return QString(fptr_lpGetStrKeyStrVal(key.toStdString().c_str(), defValue.toStdString().c_str()));
 }
@@ -1744,6 +1891,7 @@ int UnitsyncHandler::processUnitsNoChecksum() {
         logger.error("Bad function pointer: ProcessUnitsNoChecksum");
         throw bad_fptr("ProcessUnitsNoChecksum");
     }
+    Activity activity("unitsync ProcessUnitsNoChecksum");
     logger.debug("call ProcessUnitsNoChecksum(", ")");
     return fptr_ProcessUnitsNoChecksum();
 }
@@ -1752,6 +1900,7 @@ QString UnitsyncHandler::getInfoValue(int index) {
         logger.error("Bad function pointer: GetInfoValue");
         throw bad_fptr("GetInfoValue");
     }
+    Activity activity("unitsync GetInfoValue");
     logger.debug("call GetInfoValue(", index, ")");
     return QString(fptr_GetInfoValue(index));
 }
@@ -1760,6 +1909,7 @@ QString UnitsyncHandler::getPrimaryModName(int index) {
         logger.error("Bad function pointer: GetPrimaryModName");
         throw bad_fptr("GetPrimaryModName");
     }
+    Activity activity("unitsync GetPrimaryModName");
     logger.debug("call GetPrimaryModName(", index, ")");
     return QString(fptr_GetPrimaryModName(index));
 }
@@ -1768,6 +1918,7 @@ QString UnitsyncHandler::getPrimaryModShortName(int index) {
         logger.error("Bad function pointer: GetPrimaryModShortName");
         throw bad_fptr("GetPrimaryModShortName");
     }
+    Activity activity("unitsync GetPrimaryModShortName");
     logger.debug("call GetPrimaryModShortName(", index, ")");
     return QString(fptr_GetPrimaryModShortName(index));
 }
@@ -1776,6 +1927,7 @@ QString UnitsyncHandler::getPrimaryModVersion(int index) {
         logger.error("Bad function pointer: GetPrimaryModVersion");
         throw bad_fptr("GetPrimaryModVersion");
     }
+    Activity activity("unitsync GetPrimaryModVersion");
     logger.debug("call GetPrimaryModVersion(", index, ")");
     return QString(fptr_GetPrimaryModVersion(index));
 }
@@ -1784,6 +1936,7 @@ QString UnitsyncHandler::getPrimaryModMutator(int index) {
         logger.error("Bad function pointer: GetPrimaryModMutator");
         throw bad_fptr("GetPrimaryModMutator");
     }
+    Activity activity("unitsync GetPrimaryModMutator");
     logger.debug("call GetPrimaryModMutator(", index, ")");
     return QString(fptr_GetPrimaryModMutator(index));
 }
@@ -1792,6 +1945,7 @@ QString UnitsyncHandler::getPrimaryModGame(int index) {
         logger.error("Bad function pointer: GetPrimaryModGame");
         throw bad_fptr("GetPrimaryModGame");
     }
+    Activity activity("unitsync GetPrimaryModGame");
     logger.debug("call GetPrimaryModGame(", index, ")");
     return QString(fptr_GetPrimaryModGame(index));
 }
@@ -1800,6 +1954,7 @@ QString UnitsyncHandler::getPrimaryModShortGame(int index) {
         logger.error("Bad function pointer: GetPrimaryModShortGame");
         throw bad_fptr("GetPrimaryModShortGame");
     }
+    Activity activity("unitsync GetPrimaryModShortGame");
     logger.debug("call GetPrimaryModShortGame(", index, ")");
     return QString(fptr_GetPrimaryModShortGame(index));
 }
@@ -1808,6 +1963,7 @@ QString UnitsyncHandler::getPrimaryModDescription(int index) {
         logger.error("Bad function pointer: GetPrimaryModDescription");
         throw bad_fptr("GetPrimaryModDescription");
     }
+    Activity activity("unitsync GetPrimaryModDescription");
     logger.debug("call GetPrimaryModDescription(", index, ")");
     return QString(fptr_GetPrimaryModDescription(index));
 }
@@ -1816,6 +1972,7 @@ int UnitsyncHandler::openArchiveType(QString name, QString type) {
         logger.error("Bad function pointer: OpenArchiveType");
         throw bad_fptr("OpenArchiveType");
     }
+    Activity activity("unitsync OpenArchiveType");
     logger.debug("call OpenArchiveType(", name.toStdString().c_str(), ", ", type.toStdString().c_str(), ")");
     return fptr_OpenArchiveType(name.toStdString().c_str(), type.toStdString().c_str());
 }
@@ -1,6 +1,7 @@
 // DO NOT EDIT: THIS FILE WAS GENERATED by unitsync wrapper generator
 // from unitsynchandler_t.cpp.template. Edit that file instead.
 #include "unitsynchandler_t.h"
+#include "trace.h"
 #include <cstdio> // good ol' snprintf
 #include <boost/thread/locks.hpp>
 #if defined Q_OS_LINUX || defined Q_OS_MAC
@@ -22,6 +23,7 @@ boost::mutex UnitsyncHandlerAsync::executionMutex;
 bool UnitsyncHandlerAsync::startThread() {
     if (ready) {
         workThread = boost::thread([=](){
+            Trace::setThreadName("unitsync");
             std::function<void()> func;
             while (ready) {{
                     boost::unique_lock<boost::mutex> lock(queueMutex);
@@ -599,6 +601,7 @@ std::string UnitsyncHandlerAsync::cstrNull(const char* str) {
 void UnitsyncHandlerAsync::jsReadFileVFS(QString __id, int fd, int size) {
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync jsReadFileVFS");
         logger.debug("call jsReadFileVFS(", fd, ", ", size, ")");
         // An astute reader might ask at this point "But ikinz, why in the world do you need that offset?"
         // It turns out that on mingw from mingw-builds v4.8.1-posix-dwarf-rev5 using qt-5.2.0 in this very
@@ -621,7 +624,7 @@ void UnitsyncHandlerAsync::jsReadFileVFS(QString __id, int fd, int size) {
             std::snprintf(tmp, 8, "%%%.2hhX", readBuf[i + off]);
             res += tmp;
         }
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", res));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", std::move(res)));
     });
     queueCond.notify_all();
 }
@@ -634,9 +637,10 @@ void UnitsyncHandlerAsync::getNextError(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetNextError");
         logger.debug("call GetNextError(", ")");
         const char* res = fptr_GetNextError();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -647,9 +651,10 @@ void UnitsyncHandlerAsync::getSpringVersion(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringVersion");
         logger.debug("call GetSpringVersion(", ")");
         const char* res = fptr_GetSpringVersion();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -660,9 +665,10 @@ void UnitsyncHandlerAsync::getSpringVersionPatchset(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringVersionPatchset");
         logger.debug("call GetSpringVersionPatchset(", ")");
         const char* res = fptr_GetSpringVersionPatchset();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -673,9 +679,10 @@ void UnitsyncHandlerAsync::isSpringReleaseVersion(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync IsSpringReleaseVersion");
         logger.debug("call IsSpringReleaseVersion(", ")");
         bool res = fptr_IsSpringReleaseVersion();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "bool", (res ? "true" : "false")));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "bool", (res ? "true" : "false")));
     });
     queueCond.notify_all();
 }
@@ -686,9 +693,10 @@ void UnitsyncHandlerAsync::init(QString __id, bool isServer, int id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync Init");
         logger.debug("call Init(", isServer, ", ", id, ")");
         int res = fptr_Init(isServer, id);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -699,9 +707,10 @@ void UnitsyncHandlerAsync::unInit(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync UnInit");
         logger.debug("call UnInit(", ")");
         fptr_UnInit();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -712,9 +721,10 @@ void UnitsyncHandlerAsync::getWritableDataDirectory(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetWritableDataDirectory");
         logger.debug("call GetWritableDataDirectory(", ")");
         const char* res = fptr_GetWritableDataDirectory();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -725,9 +735,10 @@ void UnitsyncHandlerAsync::getDataDirectoryCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetDataDirectoryCount");
         logger.debug("call GetDataDirectoryCount(", ")");
         int res = fptr_GetDataDirectoryCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -738,9 +749,10 @@ void UnitsyncHandlerAsync::getDataDirectory(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetDataDirectory");
         logger.debug("call GetDataDirectory(", index, ")");
         const char* res = fptr_GetDataDirectory(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -751,9 +763,10 @@ void UnitsyncHandlerAsync::processUnits(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync ProcessUnits");
         logger.debug("call ProcessUnits(", ")");
         int res = fptr_ProcessUnits();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -764,9 +777,10 @@ void UnitsyncHandlerAsync::getUnitCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetUnitCount");
         logger.debug("call GetUnitCount(", ")");
         int res = fptr_GetUnitCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -777,9 +791,10 @@ void UnitsyncHandlerAsync::getUnitName(QString __id, int unit) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetUnitName");
         logger.debug("call GetUnitName(", unit, ")");
         const char* res = fptr_GetUnitName(unit);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -790,9 +805,10 @@ void UnitsyncHandlerAsync::getFullUnitName(QString __id, int unit) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetFullUnitName");
         logger.debug("call GetFullUnitName(", unit, ")");
         const char* res = fptr_GetFullUnitName(unit);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -803,9 +819,10 @@ void UnitsyncHandlerAsync::addArchive(QString __id, QString archiveName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync AddArchive");
         logger.debug("call AddArchive(", archiveName.toStdString().c_str(), ")");
         fptr_AddArchive(archiveName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -816,9 +833,10 @@ void UnitsyncHandlerAsync::addAllArchives(QString __id, QString rootArchiveName)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync AddAllArchives");
         logger.debug("call AddAllArchives(", rootArchiveName.toStdString().c_str(), ")");
         fptr_AddAllArchives(rootArchiveName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -829,9 +847,10 @@ void UnitsyncHandlerAsync::removeAllArchives(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync RemoveAllArchives");
         logger.debug("call RemoveAllArchives(", ")");
         fptr_RemoveAllArchives();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -842,9 +861,10 @@ void UnitsyncHandlerAsync::getArchiveChecksum(QString __id, QString archiveName)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetArchiveChecksum");
         logger.debug("call GetArchiveChecksum(", archiveName.toStdString().c_str(), ")");
         unsigned int res = fptr_GetArchiveChecksum(archiveName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -855,9 +875,10 @@ void UnitsyncHandlerAsync::getArchivePath(QString __id, QString archiveName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetArchivePath");
         logger.debug("call GetArchivePath(", archiveName.toStdString().c_str(), ")");
         const char* res = fptr_GetArchivePath(archiveName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -868,9 +889,10 @@ void UnitsyncHandlerAsync::getMapCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapCount");
         logger.debug("call GetMapCount(", ")");
         int res = fptr_GetMapCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -881,9 +903,10 @@ void UnitsyncHandlerAsync::getMapName(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapName");
         logger.debug("call GetMapName(", index, ")");
         const char* res = fptr_GetMapName(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -894,9 +917,10 @@ void UnitsyncHandlerAsync::getMapFileName(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapFileName");
         logger.debug("call GetMapFileName(", index, ")");
         const char* res = fptr_GetMapFileName(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -907,9 +931,10 @@ void UnitsyncHandlerAsync::getMapDescription(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapDescription");
         logger.debug("call GetMapDescription(", index, ")");
         const char* res = fptr_GetMapDescription(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -920,9 +945,10 @@ void UnitsyncHandlerAsync::getMapAuthor(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapAuthor");
         logger.debug("call GetMapAuthor(", index, ")");
         const char* res = fptr_GetMapAuthor(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -933,9 +959,10 @@ void UnitsyncHandlerAsync::getMapWidth(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapWidth");
         logger.debug("call GetMapWidth(", index, ")");
         int res = fptr_GetMapWidth(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -946,9 +973,10 @@ void UnitsyncHandlerAsync::getMapHeight(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapHeight");
         logger.debug("call GetMapHeight(", index, ")");
         int res = fptr_GetMapHeight(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -959,9 +987,10 @@ void UnitsyncHandlerAsync::getMapTidalStrength(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapTidalStrength");
         logger.debug("call GetMapTidalStrength(", index, ")");
         int res = fptr_GetMapTidalStrength(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -972,9 +1001,10 @@ void UnitsyncHandlerAsync::getMapWindMin(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapWindMin");
         logger.debug("call GetMapWindMin(", index, ")");
         int res = fptr_GetMapWindMin(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -985,9 +1015,10 @@ void UnitsyncHandlerAsync::getMapWindMax(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapWindMax");
         logger.debug("call GetMapWindMax(", index, ")");
         int res = fptr_GetMapWindMax(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -998,9 +1029,10 @@ void UnitsyncHandlerAsync::getMapGravity(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapGravity");
         logger.debug("call GetMapGravity(", index, ")");
         int res = fptr_GetMapGravity(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1011,9 +1043,10 @@ void UnitsyncHandlerAsync::getMapResourceCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapResourceCount");
         logger.debug("call GetMapResourceCount(", index, ")");
         int res = fptr_GetMapResourceCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1024,9 +1057,10 @@ void UnitsyncHandlerAsync::getMapResourceName(QString __id, int index, int resou
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapResourceName");
         logger.debug("call GetMapResourceName(", index, ", ", resourceIndex, ")");
         const char* res = fptr_GetMapResourceName(index, resourceIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1037,9 +1071,10 @@ void UnitsyncHandlerAsync::getMapResourceMax(QString __id, int index, int resour
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapResourceMax");
         logger.debug("call GetMapResourceMax(", index, ", ", resourceIndex, ")");
         float res = fptr_GetMapResourceMax(index, resourceIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1050,9 +1085,10 @@ void UnitsyncHandlerAsync::getMapResourceExtractorRadius(QString __id, int index
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapResourceExtractorRadius");
         logger.debug("call GetMapResourceExtractorRadius(", index, ", ", resourceIndex, ")");
         int res = fptr_GetMapResourceExtractorRadius(index, resourceIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1063,9 +1099,10 @@ void UnitsyncHandlerAsync::getMapPosCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapPosCount");
         logger.debug("call GetMapPosCount(", index, ")");
         int res = fptr_GetMapPosCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1076,9 +1113,10 @@ void UnitsyncHandlerAsync::getMapPosX(QString __id, int index, int posIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapPosX");
         logger.debug("call GetMapPosX(", index, ", ", posIndex, ")");
         float res = fptr_GetMapPosX(index, posIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1089,9 +1127,10 @@ void UnitsyncHandlerAsync::getMapPosZ(QString __id, int index, int posIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapPosZ");
         logger.debug("call GetMapPosZ(", index, ", ", posIndex, ")");
         float res = fptr_GetMapPosZ(index, posIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1102,9 +1141,10 @@ void UnitsyncHandlerAsync::getMapMinHeight(QString __id, QString mapName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapMinHeight");
         logger.debug("call GetMapMinHeight(", mapName.toStdString().c_str(), ")");
         float res = fptr_GetMapMinHeight(mapName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1115,9 +1155,10 @@ void UnitsyncHandlerAsync::getMapMaxHeight(QString __id, QString mapName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapMaxHeight");
         logger.debug("call GetMapMaxHeight(", mapName.toStdString().c_str(), ")");
         float res = fptr_GetMapMaxHeight(mapName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1128,9 +1169,10 @@ void UnitsyncHandlerAsync::getMapArchiveCount(QString __id, QString mapName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapArchiveCount");
         logger.debug("call GetMapArchiveCount(", mapName.toStdString().c_str(), ")");
         int res = fptr_GetMapArchiveCount(mapName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1141,9 +1183,10 @@ void UnitsyncHandlerAsync::getMapArchiveName(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapArchiveName");
         logger.debug("call GetMapArchiveName(", index, ")");
         const char* res = fptr_GetMapArchiveName(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1154,9 +1197,10 @@ void UnitsyncHandlerAsync::getMapChecksum(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapChecksum");
         logger.debug("call GetMapChecksum(", index, ")");
         unsigned int res = fptr_GetMapChecksum(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1167,9 +1211,10 @@ void UnitsyncHandlerAsync::getMapChecksumFromName(QString __id, QString mapName)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapChecksumFromName");
         logger.debug("call GetMapChecksumFromName(", mapName.toStdString().c_str(), ")");
         unsigned int res = fptr_GetMapChecksumFromName(mapName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1180,9 +1225,10 @@ void UnitsyncHandlerAsync::getSkirmishAICount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSkirmishAICount");
         logger.debug("call GetSkirmishAICount(", ")");
         int res = fptr_GetSkirmishAICount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1193,9 +1239,10 @@ void UnitsyncHandlerAsync::getSkirmishAIInfoCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSkirmishAIInfoCount");
         logger.debug("call GetSkirmishAIInfoCount(", index, ")");
         int res = fptr_GetSkirmishAIInfoCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1206,9 +1253,10 @@ void UnitsyncHandlerAsync::getInfoKey(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoKey");
         logger.debug("call GetInfoKey(", index, ")");
         const char* res = fptr_GetInfoKey(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1219,9 +1267,10 @@ void UnitsyncHandlerAsync::getInfoType(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoType");
         logger.debug("call GetInfoType(", index, ")");
         const char* res = fptr_GetInfoType(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1232,9 +1281,10 @@ void UnitsyncHandlerAsync::getInfoValueString(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoValueString");
         logger.debug("call GetInfoValueString(", index, ")");
         const char* res = fptr_GetInfoValueString(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1245,9 +1295,10 @@ void UnitsyncHandlerAsync::getInfoValueInteger(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoValueInteger");
         logger.debug("call GetInfoValueInteger(", index, ")");
         int res = fptr_GetInfoValueInteger(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1258,9 +1309,10 @@ void UnitsyncHandlerAsync::getInfoValueFloat(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoValueFloat");
         logger.debug("call GetInfoValueFloat(", index, ")");
         float res = fptr_GetInfoValueFloat(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1271,9 +1323,10 @@ void UnitsyncHandlerAsync::getInfoValueBool(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoValueBool");
         logger.debug("call GetInfoValueBool(", index, ")");
         bool res = fptr_GetInfoValueBool(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "bool", (res ? "true" : "false")));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "bool", (res ? "true" : "false")));
     });
     queueCond.notify_all();
 }
@@ -1284,9 +1337,10 @@ void UnitsyncHandlerAsync::getInfoDescription(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoDescription");
         logger.debug("call GetInfoDescription(", index, ")");
         const char* res = fptr_GetInfoDescription(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1297,9 +1351,10 @@ void UnitsyncHandlerAsync::getSkirmishAIOptionCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSkirmishAIOptionCount");
         logger.debug("call GetSkirmishAIOptionCount(", index, ")");
         int res = fptr_GetSkirmishAIOptionCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1310,9 +1365,10 @@ void UnitsyncHandlerAsync::getPrimaryModCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModCount");
         logger.debug("call GetPrimaryModCount(", ")");
         int res = fptr_GetPrimaryModCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1323,9 +1379,10 @@ void UnitsyncHandlerAsync::getPrimaryModInfoCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModInfoCount");
         logger.debug("call GetPrimaryModInfoCount(", index, ")");
         int res = fptr_GetPrimaryModInfoCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1336,9 +1393,10 @@ void UnitsyncHandlerAsync::getPrimaryModArchive(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModArchive");
         logger.debug("call GetPrimaryModArchive(", index, ")");
         const char* res = fptr_GetPrimaryModArchive(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1349,9 +1407,10 @@ void UnitsyncHandlerAsync::getPrimaryModArchiveCount(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModArchiveCount");
         logger.debug("call GetPrimaryModArchiveCount(", index, ")");
         int res = fptr_GetPrimaryModArchiveCount(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1362,9 +1421,10 @@ void UnitsyncHandlerAsync::getPrimaryModArchiveList(QString __id, int archive) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModArchiveList");
         logger.debug("call GetPrimaryModArchiveList(", archive, ")");
         const char* res = fptr_GetPrimaryModArchiveList(archive);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1375,9 +1435,10 @@ void UnitsyncHandlerAsync::getPrimaryModIndex(QString __id, QString name) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModIndex");
         logger.debug("call GetPrimaryModIndex(", name.toStdString().c_str(), ")");
         int res = fptr_GetPrimaryModIndex(name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1388,9 +1449,10 @@ void UnitsyncHandlerAsync::getPrimaryModChecksum(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModChecksum");
         logger.debug("call GetPrimaryModChecksum(", index, ")");
         unsigned int res = fptr_GetPrimaryModChecksum(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1401,9 +1463,10 @@ void UnitsyncHandlerAsync::getPrimaryModChecksumFromName(QString __id, QString n
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModChecksumFromName");
         logger.debug("call GetPrimaryModChecksumFromName(", name.toStdString().c_str(), ")");
         unsigned int res = fptr_GetPrimaryModChecksumFromName(name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "unsigned int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1414,9 +1477,10 @@ void UnitsyncHandlerAsync::getSideCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSideCount");
         logger.debug("call GetSideCount(", ")");
         int res = fptr_GetSideCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1427,9 +1491,10 @@ void UnitsyncHandlerAsync::getSideName(QString __id, int side) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSideName");
         logger.debug("call GetSideName(", side, ")");
         const char* res = fptr_GetSideName(side);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1440,9 +1505,10 @@ void UnitsyncHandlerAsync::getSideStartUnit(QString __id, int side) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSideStartUnit");
         logger.debug("call GetSideStartUnit(", side, ")");
         const char* res = fptr_GetSideStartUnit(side);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1453,9 +1519,10 @@ void UnitsyncHandlerAsync::getMapOptionCount(QString __id, QString mapName) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetMapOptionCount");
         logger.debug("call GetMapOptionCount(", mapName.toStdString().c_str(), ")");
         int res = fptr_GetMapOptionCount(mapName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1466,9 +1533,10 @@ void UnitsyncHandlerAsync::getModOptionCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetModOptionCount");
         logger.debug("call GetModOptionCount(", ")");
         int res = fptr_GetModOptionCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1479,9 +1547,10 @@ void UnitsyncHandlerAsync::getCustomOptionCount(QString __id, QString fileName)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetCustomOptionCount");
         logger.debug("call GetCustomOptionCount(", fileName.toStdString().c_str(), ")");
         int res = fptr_GetCustomOptionCount(fileName.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1492,9 +1561,10 @@ void UnitsyncHandlerAsync::getOptionKey(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionKey");
         logger.debug("call GetOptionKey(", optIndex, ")");
         const char* res = fptr_GetOptionKey(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1505,9 +1575,10 @@ void UnitsyncHandlerAsync::getOptionScope(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionScope");
         logger.debug("call GetOptionScope(", optIndex, ")");
         const char* res = fptr_GetOptionScope(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1518,9 +1589,10 @@ void UnitsyncHandlerAsync::getOptionName(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionName");
         logger.debug("call GetOptionName(", optIndex, ")");
         const char* res = fptr_GetOptionName(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1531,9 +1603,10 @@ void UnitsyncHandlerAsync::getOptionSection(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionSection");
         logger.debug("call GetOptionSection(", optIndex, ")");
         const char* res = fptr_GetOptionSection(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1544,9 +1617,10 @@ void UnitsyncHandlerAsync::getOptionStyle(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionStyle");
         logger.debug("call GetOptionStyle(", optIndex, ")");
         const char* res = fptr_GetOptionStyle(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1557,9 +1631,10 @@ void UnitsyncHandlerAsync::getOptionDesc(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionDesc");
         logger.debug("call GetOptionDesc(", optIndex, ")");
         const char* res = fptr_GetOptionDesc(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1570,9 +1645,10 @@ void UnitsyncHandlerAsync::getOptionType(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionType");
         logger.debug("call GetOptionType(", optIndex, ")");
         int res = fptr_GetOptionType(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1583,9 +1659,10 @@ void UnitsyncHandlerAsync::getOptionBoolDef(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionBoolDef");
         logger.debug("call GetOptionBoolDef(", optIndex, ")");
         int res = fptr_GetOptionBoolDef(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1596,9 +1673,10 @@ void UnitsyncHandlerAsync::getOptionNumberDef(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionNumberDef");
         logger.debug("call GetOptionNumberDef(", optIndex, ")");
         float res = fptr_GetOptionNumberDef(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1609,9 +1687,10 @@ void UnitsyncHandlerAsync::getOptionNumberMin(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionNumberMin");
         logger.debug("call GetOptionNumberMin(", optIndex, ")");
         float res = fptr_GetOptionNumberMin(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1622,9 +1701,10 @@ void UnitsyncHandlerAsync::getOptionNumberMax(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionNumberMax");
         logger.debug("call GetOptionNumberMax(", optIndex, ")");
         float res = fptr_GetOptionNumberMax(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1635,9 +1715,10 @@ void UnitsyncHandlerAsync::getOptionNumberStep(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionNumberStep");
         logger.debug("call GetOptionNumberStep(", optIndex, ")");
         float res = fptr_GetOptionNumberStep(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1648,9 +1729,10 @@ void UnitsyncHandlerAsync::getOptionStringDef(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionStringDef");
         logger.debug("call GetOptionStringDef(", optIndex, ")");
         const char* res = fptr_GetOptionStringDef(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1661,9 +1743,10 @@ void UnitsyncHandlerAsync::getOptionStringMaxLen(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionStringMaxLen");
         logger.debug("call GetOptionStringMaxLen(", optIndex, ")");
         int res = fptr_GetOptionStringMaxLen(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1674,9 +1757,10 @@ void UnitsyncHandlerAsync::getOptionListCount(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionListCount");
         logger.debug("call GetOptionListCount(", optIndex, ")");
         int res = fptr_GetOptionListCount(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1687,9 +1771,10 @@ void UnitsyncHandlerAsync::getOptionListDef(QString __id, int optIndex) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionListDef");
         logger.debug("call GetOptionListDef(", optIndex, ")");
         const char* res = fptr_GetOptionListDef(optIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1700,9 +1785,10 @@ void UnitsyncHandlerAsync::getOptionListItemKey(QString __id, int optIndex, int
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionListItemKey");
         logger.debug("call GetOptionListItemKey(", optIndex, ", ", itemIndex, ")");
         const char* res = fptr_GetOptionListItemKey(optIndex, itemIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1713,9 +1799,10 @@ void UnitsyncHandlerAsync::getOptionListItemName(QString __id, int optIndex, int
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionListItemName");
         logger.debug("call GetOptionListItemName(", optIndex, ", ", itemIndex, ")");
         const char* res = fptr_GetOptionListItemName(optIndex, itemIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1726,9 +1813,10 @@ void UnitsyncHandlerAsync::getOptionListItemDesc(QString __id, int optIndex, int
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetOptionListItemDesc");
         logger.debug("call GetOptionListItemDesc(", optIndex, ", ", itemIndex, ")");
         const char* res = fptr_GetOptionListItemDesc(optIndex, itemIndex);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1739,9 +1827,10 @@ void UnitsyncHandlerAsync::getModValidMapCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetModValidMapCount");
         logger.debug("call GetModValidMapCount(", ")");
         int res = fptr_GetModValidMapCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1752,9 +1841,10 @@ void UnitsyncHandlerAsync::getModValidMap(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetModValidMap");
         logger.debug("call GetModValidMap(", index, ")");
         const char* res = fptr_GetModValidMap(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1765,9 +1855,10 @@ void UnitsyncHandlerAsync::openFileVFS(QString __id, QString name) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync OpenFileVFS");
         logger.debug("call OpenFileVFS(", name.toStdString().c_str(), ")");
         int res = fptr_OpenFileVFS(name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1778,9 +1869,10 @@ void UnitsyncHandlerAsync::closeFileVFS(QString __id, int file) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync CloseFileVFS");
         logger.debug("call CloseFileVFS(", file, ")");
         fptr_CloseFileVFS(file);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1791,9 +1883,10 @@ void UnitsyncHandlerAsync::fileSizeVFS(QString __id, int file) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync FileSizeVFS");
         logger.debug("call FileSizeVFS(", file, ")");
         int res = fptr_FileSizeVFS(file);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1804,9 +1897,10 @@ void UnitsyncHandlerAsync::initFindVFS(QString __id, QString pattern) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync InitFindVFS");
         logger.debug("call InitFindVFS(", pattern.toStdString().c_str(), ")");
         int res = fptr_InitFindVFS(pattern.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1817,9 +1911,10 @@ void UnitsyncHandlerAsync::initDirListVFS(QString __id, QString path, QString pa
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync InitDirListVFS");
         logger.debug("call InitDirListVFS(", path.toStdString().c_str(), ", ", pattern.toStdString().c_str(), ", ", modes.toStdString().c_str(), ")");
         int res = fptr_InitDirListVFS(path.toStdString().c_str(), pattern.toStdString().c_str(), modes.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1830,9 +1925,10 @@ void UnitsyncHandlerAsync::initSubDirsVFS(QString __id, QString path, QString pa
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync InitSubDirsVFS");
         logger.debug("call InitSubDirsVFS(", path.toStdString().c_str(), ", ", pattern.toStdString().c_str(), ", ", modes.toStdString().c_str(), ")");
         int res = fptr_InitSubDirsVFS(path.toStdString().c_str(), pattern.toStdString().c_str(), modes.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1843,9 +1939,10 @@ void UnitsyncHandlerAsync::openArchive(QString __id, QString name) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync OpenArchive");
         logger.debug("call OpenArchive(", name.toStdString().c_str(), ")");
         int res = fptr_OpenArchive(name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1856,9 +1953,10 @@ void UnitsyncHandlerAsync::closeArchive(QString __id, int archive) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync CloseArchive");
         logger.debug("call CloseArchive(", archive, ")");
         fptr_CloseArchive(archive);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1869,9 +1967,10 @@ void UnitsyncHandlerAsync::openArchiveFile(QString __id, int archive, QString na
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync OpenArchiveFile");
         logger.debug("call OpenArchiveFile(", archive, ", ", name.toStdString().c_str(), ")");
         int res = fptr_OpenArchiveFile(archive, name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1882,9 +1981,10 @@ void UnitsyncHandlerAsync::closeArchiveFile(QString __id, int archive, int file)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync CloseArchiveFile");
         logger.debug("call CloseArchiveFile(", archive, ", ", file, ")");
         fptr_CloseArchiveFile(archive, file);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1895,9 +1995,10 @@ void UnitsyncHandlerAsync::sizeArchiveFile(QString __id, int archive, int file)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync SizeArchiveFile");
         logger.debug("call SizeArchiveFile(", archive, ", ", file, ")");
         int res = fptr_SizeArchiveFile(archive, file);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1908,9 +2009,10 @@ void UnitsyncHandlerAsync::setSpringConfigFile(QString __id, QString fileNameAsA
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync SetSpringConfigFile");
         logger.debug("call SetSpringConfigFile(", fileNameAsAbsolutePath.toStdString().c_str(), ")");
         fptr_SetSpringConfigFile(fileNameAsAbsolutePath.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1921,9 +2023,10 @@ void UnitsyncHandlerAsync::getSpringConfigFile(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringConfigFile");
         logger.debug("call GetSpringConfigFile(", ")");
         const char* res = fptr_GetSpringConfigFile();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1934,9 +2037,10 @@ void UnitsyncHandlerAsync::getSpringConfigString(QString __id, QString name, QSt
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringConfigString");
         logger.debug("call GetSpringConfigString(", name.toStdString().c_str(), ", ", defValue.toStdString().c_str(), ")");
         const char* res = fptr_GetSpringConfigString(name.toStdString().c_str(), defValue.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -1947,9 +2051,10 @@ void UnitsyncHandlerAsync::getSpringConfigInt(QString __id, QString name, int de
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringConfigInt");
         logger.debug("call GetSpringConfigInt(", name.toStdString().c_str(), ", ", defValue, ")");
         int res = fptr_GetSpringConfigInt(name.toStdString().c_str(), defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1960,9 +2065,10 @@ void UnitsyncHandlerAsync::getSpringConfigFloat(QString __id, QString name, floa
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetSpringConfigFloat");
         logger.debug("call GetSpringConfigFloat(", name.toStdString().c_str(), ", ", defValue, ")");
         float res = fptr_GetSpringConfigFloat(name.toStdString().c_str(), defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -1973,9 +2079,10 @@ void UnitsyncHandlerAsync::setSpringConfigString(QString __id, QString name, QSt
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync SetSpringConfigString");
         logger.debug("call SetSpringConfigString(", name.toStdString().c_str(), ", ", value.toStdString().c_str(), ")");
         fptr_SetSpringConfigString(name.toStdString().c_str(), value.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1986,9 +2093,10 @@ void UnitsyncHandlerAsync::setSpringConfigInt(QString __id, QString name, int va
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync SetSpringConfigInt");
         logger.debug("call SetSpringConfigInt(", name.toStdString().c_str(), ", ", value, ")");
         fptr_SetSpringConfigInt(name.toStdString().c_str(), value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -1999,9 +2107,10 @@ void UnitsyncHandlerAsync::setSpringConfigFloat(QString __id, QString name, floa
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync SetSpringConfigFloat");
         logger.debug("call SetSpringConfigFloat(", name.toStdString().c_str(), ", ", value, ")");
         fptr_SetSpringConfigFloat(name.toStdString().c_str(), value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2012,9 +2121,10 @@ void UnitsyncHandlerAsync::deleteSpringConfigKey(QString __id, QString name) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync DeleteSpringConfigKey");
         logger.debug("call DeleteSpringConfigKey(", name.toStdString().c_str(), ")");
         fptr_DeleteSpringConfigKey(name.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2025,9 +2135,10 @@ void UnitsyncHandlerAsync::lpClose(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpClose");
         logger.debug("call lpClose(", ")");
         fptr_lpClose();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2038,9 +2149,10 @@ void UnitsyncHandlerAsync::lpOpenFile(QString __id, QString fileName, QString fi
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpOpenFile");
         logger.debug("call lpOpenFile(", fileName.toStdString().c_str(), ", ", fileModes.toStdString().c_str(), ", ", accessModes.toStdString().c_str(), ")");
         int res = fptr_lpOpenFile(fileName.toStdString().c_str(), fileModes.toStdString().c_str(), accessModes.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2051,9 +2163,10 @@ void UnitsyncHandlerAsync::lpOpenSource(QString __id, QString source, QString ac
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpOpenSource");
         logger.debug("call lpOpenSource(", source.toStdString().c_str(), ", ", accessModes.toStdString().c_str(), ")");
         int res = fptr_lpOpenSource(source.toStdString().c_str(), accessModes.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2064,9 +2177,10 @@ void UnitsyncHandlerAsync::lpExecute(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpExecute");
         logger.debug("call lpExecute(", ")");
         int res = fptr_lpExecute();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2077,9 +2191,10 @@ void UnitsyncHandlerAsync::lpErrorLog(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpErrorLog");
         logger.debug("call lpErrorLog(", ")");
         const char* res = fptr_lpErrorLog();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2090,9 +2205,10 @@ void UnitsyncHandlerAsync::lpAddTableInt(QString __id, int key, int override) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddTableInt");
         logger.debug("call lpAddTableInt(", key, ", ", override, ")");
         fptr_lpAddTableInt(key, override);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2103,9 +2219,10 @@ void UnitsyncHandlerAsync::lpAddTableStr(QString __id, QString key, int override
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddTableStr");
         logger.debug("call lpAddTableStr(", key.toStdString().c_str(), ", ", override, ")");
         fptr_lpAddTableStr(key.toStdString().c_str(), override);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2116,9 +2233,10 @@ void UnitsyncHandlerAsync::lpEndTable(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpEndTable");
         logger.debug("call lpEndTable(", ")");
         fptr_lpEndTable();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2129,9 +2247,10 @@ void UnitsyncHandlerAsync::lpAddIntKeyIntVal(QString __id, int key, int value) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddIntKeyIntVal");
         logger.debug("call lpAddIntKeyIntVal(", key, ", ", value, ")");
         fptr_lpAddIntKeyIntVal(key, value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2142,9 +2261,10 @@ void UnitsyncHandlerAsync::lpAddStrKeyIntVal(QString __id, QString key, int valu
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddStrKeyIntVal");
         logger.debug("call lpAddStrKeyIntVal(", key.toStdString().c_str(), ", ", value, ")");
         fptr_lpAddStrKeyIntVal(key.toStdString().c_str(), value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2155,9 +2275,10 @@ void UnitsyncHandlerAsync::lpAddIntKeyBoolVal(QString __id, int key, int value)
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddIntKeyBoolVal");
         logger.debug("call lpAddIntKeyBoolVal(", key, ", ", value, ")");
         fptr_lpAddIntKeyBoolVal(key, value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2168,9 +2289,10 @@ void UnitsyncHandlerAsync::lpAddStrKeyBoolVal(QString __id, QString key, int val
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddStrKeyBoolVal");
         logger.debug("call lpAddStrKeyBoolVal(", key.toStdString().c_str(), ", ", value, ")");
         fptr_lpAddStrKeyBoolVal(key.toStdString().c_str(), value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2181,9 +2303,10 @@ void UnitsyncHandlerAsync::lpAddIntKeyFloatVal(QString __id, int key, float valu
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddIntKeyFloatVal");
         logger.debug("call lpAddIntKeyFloatVal(", key, ", ", value, ")");
         fptr_lpAddIntKeyFloatVal(key, value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2194,9 +2317,10 @@ void UnitsyncHandlerAsync::lpAddStrKeyFloatVal(QString __id, QString key, float
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddStrKeyFloatVal");
         logger.debug("call lpAddStrKeyFloatVal(", key.toStdString().c_str(), ", ", value, ")");
         fptr_lpAddStrKeyFloatVal(key.toStdString().c_str(), value);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2207,9 +2331,10 @@ void UnitsyncHandlerAsync::lpAddIntKeyStrVal(QString __id, int key, QString valu
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddIntKeyStrVal");
         logger.debug("call lpAddIntKeyStrVal(", key, ", ", value.toStdString().c_str(), ")");
         fptr_lpAddIntKeyStrVal(key, value.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2220,9 +2345,10 @@ void UnitsyncHandlerAsync::lpAddStrKeyStrVal(QString __id, QString key, QString
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpAddStrKeyStrVal");
         logger.debug("call lpAddStrKeyStrVal(", key.toStdString().c_str(), ", ", value.toStdString().c_str(), ")");
         fptr_lpAddStrKeyStrVal(key.toStdString().c_str(), value.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2233,9 +2359,10 @@ void UnitsyncHandlerAsync::lpRootTable(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpRootTable");
         logger.debug("call lpRootTable(", ")");
         int res = fptr_lpRootTable();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2246,9 +2373,10 @@ void UnitsyncHandlerAsync::lpRootTableExpr(QString __id, QString expr) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpRootTableExpr");
         logger.debug("call lpRootTableExpr(", expr.toStdString().c_str(), ")");
         int res = fptr_lpRootTableExpr(expr.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2259,9 +2387,10 @@ void UnitsyncHandlerAsync::lpSubTableInt(QString __id, int key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpSubTableInt");
         logger.debug("call lpSubTableInt(", key, ")");
         int res = fptr_lpSubTableInt(key);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2272,9 +2401,10 @@ void UnitsyncHandlerAsync::lpSubTableStr(QString __id, QString key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpSubTableStr");
         logger.debug("call lpSubTableStr(", key.toStdString().c_str(), ")");
         int res = fptr_lpSubTableStr(key.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2285,9 +2415,10 @@ void UnitsyncHandlerAsync::lpSubTableExpr(QString __id, QString expr) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpSubTableExpr");
         logger.debug("call lpSubTableExpr(", expr.toStdString().c_str(), ")");
         int res = fptr_lpSubTableExpr(expr.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2298,9 +2429,10 @@ void UnitsyncHandlerAsync::lpPopTable(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpPopTable");
         logger.debug("call lpPopTable(", ")");
         fptr_lpPopTable();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "void", ""));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "void", ""));
     });
     queueCond.notify_all();
 }
@@ -2311,9 +2443,10 @@ void UnitsyncHandlerAsync::lpGetKeyExistsInt(QString __id, int key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetKeyExistsInt");
         logger.debug("call lpGetKeyExistsInt(", key, ")");
         int res = fptr_lpGetKeyExistsInt(key);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2324,9 +2457,10 @@ void UnitsyncHandlerAsync::lpGetKeyExistsStr(QString __id, QString key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetKeyExistsStr");
         logger.debug("call lpGetKeyExistsStr(", key.toStdString().c_str(), ")");
         int res = fptr_lpGetKeyExistsStr(key.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2337,9 +2471,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyType(QString __id, int key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyType");
         logger.debug("call lpGetIntKeyType(", key, ")");
         int res = fptr_lpGetIntKeyType(key);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2350,9 +2485,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyType(QString __id, QString key) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyType");
         logger.debug("call lpGetStrKeyType(", key.toStdString().c_str(), ")");
         int res = fptr_lpGetStrKeyType(key.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2363,9 +2499,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyListCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyListCount");
         logger.debug("call lpGetIntKeyListCount(", ")");
         int res = fptr_lpGetIntKeyListCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2376,9 +2513,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyListEntry(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyListEntry");
         logger.debug("call lpGetIntKeyListEntry(", index, ")");
         int res = fptr_lpGetIntKeyListEntry(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2389,9 +2527,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyListCount(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyListCount");
         logger.debug("call lpGetStrKeyListCount(", ")");
         int res = fptr_lpGetStrKeyListCount();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2402,9 +2541,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyListEntry(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyListEntry");
         logger.debug("call lpGetStrKeyListEntry(", index, ")");
         const char* res = fptr_lpGetStrKeyListEntry(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2415,9 +2555,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyIntVal(QString __id, int key, int defValue
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyIntVal");
         logger.debug("call lpGetIntKeyIntVal(", key, ", ", defValue, ")");
         int res = fptr_lpGetIntKeyIntVal(key, defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2428,9 +2569,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyIntVal(QString __id, QString key, int defV
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyIntVal");
         logger.debug("call lpGetStrKeyIntVal(", key.toStdString().c_str(), ", ", defValue, ")");
         int res = fptr_lpGetStrKeyIntVal(key.toStdString().c_str(), defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2441,9 +2583,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyBoolVal(QString __id, int key, int defValu
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyBoolVal");
         logger.debug("call lpGetIntKeyBoolVal(", key, ", ", defValue, ")");
         int res = fptr_lpGetIntKeyBoolVal(key, defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2454,9 +2597,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyBoolVal(QString __id, QString key, int def
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyBoolVal");
         logger.debug("call lpGetStrKeyBoolVal(", key.toStdString().c_str(), ", ", defValue, ")");
         int res = fptr_lpGetStrKeyBoolVal(key.toStdString().c_str(), defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2467,9 +2611,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyFloatVal(QString __id, int key, float defV
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyFloatVal");
         logger.debug("call lpGetIntKeyFloatVal(", key, ", ", defValue, ")");
         float res = fptr_lpGetIntKeyFloatVal(key, defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2480,9 +2625,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyFloatVal(QString __id, QString key, float
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyFloatVal");
         logger.debug("call lpGetStrKeyFloatVal(", key.toStdString().c_str(), ", ", defValue, ")");
         float res = fptr_lpGetStrKeyFloatVal(key.toStdString().c_str(), defValue);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "float", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2493,9 +2639,10 @@ void UnitsyncHandlerAsync::lpGetIntKeyStrVal(QString __id, int key, QString defV
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetIntKeyStrVal");
         logger.debug("call lpGetIntKeyStrVal(", key, ", ", defValue.toStdString().c_str(), ")");
         const char* res = fptr_lpGetIntKeyStrVal(key, defValue.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2506,9 +2653,10 @@ void UnitsyncHandlerAsync::lpGetStrKeyStrVal(QString __id, QString key, QString
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync lpGetStrKeyStrVal");
         logger.debug("call lpGetStrKeyStrVal(", key.toStdString().c_str(), ", ", defValue.toStdString().c_str(), ")");
         const char* res = fptr_lpGetStrKeyStrVal(key.toStdString().c_str(), defValue.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2519,9 +2667,10 @@ void UnitsyncHandlerAsync::processUnitsNoChecksum(QString __id) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync ProcessUnitsNoChecksum");
         logger.debug("call ProcessUnitsNoChecksum(", ")");
         int res = fptr_ProcessUnitsNoChecksum();
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -2532,9 +2681,10 @@ void UnitsyncHandlerAsync::getInfoValue(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetInfoValue");
         logger.debug("call GetInfoValue(", index, ")");
         const char* res = fptr_GetInfoValue(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2545,9 +2695,10 @@ void UnitsyncHandlerAsync::getPrimaryModName(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModName");
         logger.debug("call GetPrimaryModName(", index, ")");
         const char* res = fptr_GetPrimaryModName(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2558,9 +2709,10 @@ void UnitsyncHandlerAsync::getPrimaryModShortName(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModShortName");
         logger.debug("call GetPrimaryModShortName(", index, ")");
         const char* res = fptr_GetPrimaryModShortName(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2571,9 +2723,10 @@ void UnitsyncHandlerAsync::getPrimaryModVersion(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModVersion");
         logger.debug("call GetPrimaryModVersion(", index, ")");
         const char* res = fptr_GetPrimaryModVersion(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2584,9 +2737,10 @@ void UnitsyncHandlerAsync::getPrimaryModMutator(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModMutator");
         logger.debug("call GetPrimaryModMutator(", index, ")");
         const char* res = fptr_GetPrimaryModMutator(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2597,9 +2751,10 @@ void UnitsyncHandlerAsync::getPrimaryModGame(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModGame");
         logger.debug("call GetPrimaryModGame(", index, ")");
         const char* res = fptr_GetPrimaryModGame(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2610,9 +2765,10 @@ void UnitsyncHandlerAsync::getPrimaryModShortGame(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModShortGame");
         logger.debug("call GetPrimaryModShortGame(", index, ")");
         const char* res = fptr_GetPrimaryModShortGame(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2623,9 +2779,10 @@ void UnitsyncHandlerAsync::getPrimaryModDescription(QString __id, int index) {
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync GetPrimaryModDescription");
         logger.debug("call GetPrimaryModDescription(", index, ")");
         const char* res = fptr_GetPrimaryModDescription(index);
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "const char*", cstrNull(res)));
     });
     queueCond.notify_all();
 }
@@ -2636,9 +2793,10 @@ void UnitsyncHandlerAsync::openArchiveType(QString __id, QString name, QString t
     }
     boost::unique_lock<boost::mutex> lock(queueMutex);
     queue.push([=](){
+        TraceSpan span("unitsync OpenArchiveType");
         logger.debug("call OpenArchiveType(", name.toStdString().c_str(), ", ", type.toStdString().c_str(), ")");
         int res = fptr_OpenArchiveType(name.toStdString().c_str(), type.toStdString().c_str());
-        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
+        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), "int", std::to_string(res)));
     });
     queueCond.notify_all();
 }
@@ -4,6 +4,7 @@
 #define _UNITSYNC_HANDLER_T_H
 
 #include "logger.h"
+#include "nativeevent.h"
 #include <string>
 #include <exception>
 #include <queue>
@@ -26,9 +27,9 @@ public:
     UnitsyncHandlerAsync(UnitsyncHandlerAsync&&);
 
     // Event used when unitsync wants to send a function result to js.
-    struct ResultEvent : QEvent {
-        ResultEvent(const std::string& id, const std::string& type, const std::string& res) : QEvent(QEvent::Type(TypeId)),
-            id(id), type(type), res(res) {}
+    struct ResultEvent : NativeEvent {
+        ResultEvent(std::string id, std::string type, std::string res) : NativeEvent(TypeId, EventClass::unitsync),
+            id(std::move(id)), type(std::move(type)), res(std::move(res)) {}
         std::string id, type, res;
         static const int TypeId = QEvent::User + 5; // maybe magic numbers aren't the answer...
     };
@@ -0,0 +1,98 @@
+#include "watchdog.h"
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+long long nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::atomic<const char*> currentName(NULL);
+std::atomic<long long> currentSince(0);
+
+}
+
+Activity::Activity(const char* name) : span(name), prevName(currentName), prevSince(currentSince) {
+    currentSince = nowUs();
+    currentName = name;
+}
+
+Activity::~Activity() {
+    currentName = prevName;
+    currentSince = prevSince;
+}
+
+const char* Activity::current() {
+    return currentName;
+}
+
+long long Activity::currentFor() {
+    return nowUs() - currentSince;
+}
+
+StallWatchdog::StallWatchdog(Logger& logger, unsigned int threshold) : logger(logger), threshold(threshold),
+        lastBeat(nowUs()), stopping(false) {
+    if (threshold > 0)
+        thread = boost::thread([this]{ run(); });
+}
+
+StallWatchdog::~StallWatchdog() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.interrupt();
+        thread.join();
+    }
+    if (culprits.empty())
+        return;
+
+    std::vector<std::pair<std::string, Culprit>> sorted(culprits.begin(), culprits.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Culprit>& a,
+            const std::pair<std::string, Culprit>& b) {
+        return a.second.totalMs > b.second.totalMs;
+    });
+    logger.info("GUI thread stall summary (threshold ", threshold, " ms):");
+    for (auto& c : sorted) {
+        logger.info("  ", c.first, ": ", c.second.count, " stalls, ", c.second.totalMs, " ms total, ",
+            c.second.maxMs, " ms max");
+    }
+}
+
+void StallWatchdog::heartbeat() {
+    lastBeat = nowUs();
+}
+
+// A stall is reported once when it crosses the threshold, naming whatever the
+// GUI thread is marked to be doing, and again with the full duration once the
+// event loop spins again.
+void StallWatchdog::run() {
+    const long long thresholdUs = threshold * 1000LL;
+    bool stalled = false;
+    std::string culprit;
+    long long stallStart = 0;
+    Trace::setThreadName("watchdog");
+    try {
+        while (!stopping) {
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(std::max(threshold / 4, 10u)));
+            long long beat = lastBeat, now = nowUs();
+            if (!stalled && now - beat >= thresholdUs) {
+                stalled = true;
+                stallStart = beat;
+                const char* name = Activity::current();
+                culprit = name ? name : "unknown";
+                logger.warning("GUI thread stalled for ", (now - beat) / 1000, " ms in ", culprit,
+                    " (running for ", Activity::currentFor() / 1000, " ms)");
+            } else if (stalled && beat > stallStart) {
+                stalled = false;
+                long long ms = (beat - stallStart) / 1000;
+                logger.warning("GUI thread stall in ", culprit, " ended after ", ms, " ms");
+                Culprit& c = culprits[culprit];
+                c.count++;
+                c.totalMs += ms;
+                c.maxMs = std::max(c.maxMs, ms);
+            }
+        }
+    } catch(boost::thread_interrupted&) {}
+}
@@ -0,0 +1,59 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+// Detects when the GUI thread stops spinning the event loop and reports what
+// it was busy with at the time. The GUI thread marks what it is doing with
+// Activity objects, the watchdog thread only reads the marker.
+
+#include "logger.h"
+#include "trace.h"
+#include <atomic>
+#include <map>
+#include <string>
+#include <boost/thread.hpp>
+
+// Marks the scope as the current GUI thread activity. Only use it in the GUI
+// thread and only with string literals, the name is read asynchronously.
+// Activities also show up as spans in the trace.
+class Activity {
+public:
+    explicit Activity(const char* name);
+    ~Activity();
+
+    Activity(const Activity&) = delete;
+    Activity& operator=(const Activity&) = delete;
+
+    static const char* current();
+    // Microseconds since the current activity started.
+    static long long currentFor();
+private:
+    TraceSpan span;
+    const char* prevName;
+    long long prevSince;
+};
+
+class StallWatchdog {
+public:
+    // Stalls of at least threshold ms are logged, 0 disables the watchdog.
+    StallWatchdog(Logger&, unsigned int threshold);
+    ~StallWatchdog();
+
+    // Called by the GUI thread event loop, more often than threshold.
+    void heartbeat();
+private:
+    void run();
+
+    struct Culprit {
+        unsigned int count;
+        long long totalMs, maxMs;
+    };
+    Logger& logger;
+    unsigned int threshold;
+    std::atomic<long long> lastBeat;
+    std::atomic<bool> stopping;
+    // Only touched by the watchdog thread until it's joined.
+    std::map<std::string, Culprit> culprits;
+    boost::thread thread;
+};
+
+#endif // WATCHDOG_H
@@ -74,6 +74,7 @@ bool F5Filter::eventFilter(QObject* obj, QEvent* evt) {
     if (evt->type() == QEvent::KeyPress) {
         auto keyEvt = static_cast<QKeyEvent&>(*evt);
         if (keyEvt.key() == Qt::Key_F5) {
+            Activity activity("F5 reload");
             auto view = dynamic_cast<QWebView*>(obj);
             QUrl url = view->page()->mainFrame()->url();
             view->setPage(new MyPage(view));
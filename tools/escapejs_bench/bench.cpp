@@ -0,0 +1,138 @@
+// Compares escapejs::append() with the character by character escapeJs()
+// LobbyInterface used to have, on the kinds of payloads it actually escapes.
+
+#include "escapejs.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static std::string escapeJsOld(const std::string& str) {
+    std::string res = "";
+    for(char c : str) {
+        if(c == '\'') res += "\\'";
+        else if(c == '\\') res += "\\\\";
+        else if(c == '"') res += "\\\"";
+        else if(c == '\n') res += "\\n";
+        else if(c == '\r') res += "\\r";
+        else res += c;
+    }
+    return res;
+}
+
+static std::vector<std::string> chatLines() {
+    std::vector<std::string> lines;
+    for (int i = 0; i < 10000; i++)
+        lines.push_back("SAID main Player" + std::to_string(i) + " hey, who's up for a \"quick\" 1v1 on DeltaSiegeDry? gl hf");
+    return lines;
+}
+
+static std::vector<std::string> processLines() {
+    std::vector<std::string> lines;
+    for (int i = 0; i < 10000; i++)
+        lines.push_back("[f=0000000] Loading archive C:\\Users\\player\\Documents\\My Games\\Spring\\games\\zk-v1."
+            + std::to_string(i) + ".sdz\r");
+    return lines;
+}
+
+// What jsReadFileVFS() produces for a binary file.
+static std::vector<std::string> vfsBlob() {
+    std::string blob;
+    char tmp[8];
+    std::srand(42);
+    for (int i = 0; i < 2 * 1024 * 1024; i++) {
+        std::snprintf(tmp, 8, "%%%.2hhX", (unsigned char)std::rand());
+        blob += tmp;
+    }
+    return { blob };
+}
+
+template<typename F>
+static double run(const std::vector<std::string>& input, int reps, F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        for (auto& s : input)
+            f(s);
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+static void bench(const char* name, const std::vector<std::string>& input, int reps) {
+    std::size_t bytes = 0, sink = 0;
+    for (auto& s : input)
+        bytes += s.size();
+    double mb = double(bytes) * reps / (1024 * 1024);
+
+    double oldTime = run(input, reps, [&](const std::string& s) {
+        sink += escapeJsOld(s).size();
+    });
+    std::string buf;
+    double newTime = run(input, reps, [&](const std::string& s) {
+        buf.clear();
+        escapejs::append(buf, s);
+        sink += buf.size();
+    });
+    std::printf("%-16s old %9.1f MB/s   new %9.1f MB/s   x%.1f  (%zu)\n", name,
+        mb / oldTime, mb / newTime, oldTime / newTime, sink);
+}
+
+// U+2028 and U+2029 at every offset around the 16 byte blocks, next to
+// other escapes and cut off at the end of the input.
+static bool checkLineSeparators() {
+    for (std::size_t pad = 0; pad < 40; pad++) {
+        std::string prefix(pad, 'x');
+        struct { std::string in, out; } cases[] = {
+            { prefix + "\xE2\x80\xA8", prefix + "\\u2028" },
+            { prefix + "a\xE2\x80\xA9'b", prefix + "a\\u2029\\'b" },
+            { prefix + "\xE2\x80\xA8\xE2\x80\xA9\n", prefix + "\\u2028\\u2029\\n" },
+            { prefix + "\xE2\x82\xAC \xE2\x80", prefix + "\xE2\x82\xAC \xE2\x80" },
+        };
+        for (auto& c : cases) {
+            if (escapejs::escape(c.in) != c.out) {
+                std::printf("line separator mismatch at offset %zu: %s\n", pad, escapejs::escape(c.in).c_str());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool checkNumbers() {
+    struct { double in; const char* out; } cases[] = {
+        { 1.0 / 0.0, "null" }, { -1.0 / 0.0, "null" }, { std::nan(""), "null" }, { 42, "42" }, { -0.5, "-0.5" },
+    };
+    for (auto& c : cases) {
+        std::string out;
+        escapejs::appendNumber(out, c.in);
+        if (out != c.out) {
+            std::printf("number mismatch: %s, expected %s\n", out.c_str(), c.out);
+            return false;
+        }
+    }
+    std::string out;
+    escapejs::appendNumber(out, 0.1);
+    if (std::strtod(out.c_str(), NULL) != 0.1) {
+        std::printf("0.1 doesn't read back: %s\n", out.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    for (auto& input : { chatLines(), processLines() }) {
+        for (auto& s : input) {
+            if (escapejs::escape(s) != escapeJsOld(s)) {
+                std::printf("mismatch: %s\n", s.c_str());
+                return 1;
+            }
+        }
+    }
+    if (!checkLineSeparators() || !checkNumbers())
+        return 1;
+    bench("chat lines", chatLines(), 50);
+    bench("process output", processLines(), 50);
+    bench("vfs blob (6MB)", vfsBlob(), 10);
+    return 0;
+}
@@ -0,0 +1,196 @@
+// Headless end-to-end benchmark of the lobby path: a LobbyInterface on a
+// blank page connects to a lobby server, usually tools/lobby_standin with
+// -churn and -chat, logs in and reports the time to log in, message
+// throughput, the depth of the GUI thread's protocol event queue and how
+// memory grows while the load goes on.
+//
+// lobby_bench [-platform offscreen] [-host 127.0.0.1] [-port 8200]
+//             [-duration 30] [-compress] [-tokenize] [-batchLogin]
+//             [-mirrorState] [-js]
+//
+// Events are counted from the nativeEvents signal, with -js they go
+// through JS handlers in the page instead, like with the pages that don't
+// listen to nativeEvents.
+
+#include <QApplication>
+#include <QTimer>
+#include <QWebFrame>
+#include <QWebPage>
+#include <curl/curl.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#ifdef Q_OS_LINUX
+    #include <mpg123.h>
+    #include <unistd.h>
+#endif
+#include "lobbyinterface.h"
+
+typedef std::chrono::steady_clock clock_type;
+
+// Resident set size in kB, 0 where it isn't known.
+static long rssKb() {
+    #ifdef Q_OS_LINUX
+        long size = 0, resident = 0;
+        if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+            if (std::fscanf(f, "%ld %ld", &size, &resident) != 2)
+                resident = 0;
+            std::fclose(f);
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    #else
+        return 0;
+    #endif
+}
+
+static QString argValue(const QStringList& args, const char* name, const QString& def) {
+    int i = args.indexOf(name);
+    return i >= 0 && i + 1 < args.length() ? args[i + 1] : def;
+}
+
+static const char* jsHandlers =
+    "var bench = { lines: 0, diffs: 0, greeted: false, loginStart: 0, loginMs: -1, error: '' };"
+    "function benchLine(l) {"
+        "bench.lines++; bench.greeted = true;"
+        "if (l.lastIndexOf('LOGININFOEND', 0) === 0 && bench.loginStart) bench.loginMs = Date.now() - bench.loginStart;"
+    "}"
+    "function on_socket_get(l) { benchLine(l); }"
+    "function on_socket_command(c, args, id) { benchLine(c); }"
+    "function on_socket_login_batch(b) { bench.lines += b.lines; }"
+    "function on_state_diff(d) { bench.diffs++; }"
+    "function on_socket_error(e) { bench.error = e; }"
+    "function alert2(m) {}";
+
+struct Counters {
+    Counters() : lines(0), diffs(0), greeted(false), loginMs(-1) {}
+    unsigned long long lines, diffs;
+    bool greeted;
+    double loginMs;
+    std::string error;
+};
+
+int main(int argc, char* argv[]) {
+    curl_global_init(CURL_GLOBAL_ALL);
+    #ifdef Q_OS_LINUX
+        mpg123_init();
+    #endif
+    QApplication app(argc, argv);
+    auto args = app.arguments();
+    QString host = argValue(args, "-host", "127.0.0.1");
+    unsigned int port = argValue(args, "-port", "8200").toUInt();
+    int duration = argValue(args, "-duration", "30").toInt();
+    bool viaJs = args.contains("-js");
+    QVariantMap options;
+    for (const char* opt : { "compress", "tokenize", "batchLogin", "mirrorState" })
+        options[opt] = args.contains(QString("-") + opt);
+    if (options["mirrorState"].toBool())
+        options["stateDiffInterval"] = 100;
+
+    QWebPage page;
+    QWebFrame* frame = page.mainFrame();
+    LobbyInterface lobby(NULL, frame);
+
+    Counters native;
+    clock_type::time_point loginStart;
+    if (viaJs) {
+        frame->evaluateJavaScript(jsHandlers);
+    } else {
+        QObject::connect(&lobby, &LobbyInterface::nativeEvents, [&](QVariantList batch) {
+            for (auto& item : batch) {
+                QVariantList call = item.toList();
+                QString func = call[0].toString();
+                if (func == "on_socket_get" || func == "on_socket_command") {
+                    native.lines++;
+                    native.greeted = true;
+                    if (call[1].toString().startsWith("LOGININFOEND") && loginStart != clock_type::time_point()) {
+                        native.loginMs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            clock_type::now() - loginStart).count() / 1000.0;
+                    }
+                } else if (func == "on_socket_login_batch") {
+                    native.lines += call[1].toMap()["lines"].toULongLong();
+                } else if (func == "on_state_diff") {
+                    native.diffs++;
+                } else if (func == "on_socket_error") {
+                    native.error = call[1].toString().toStdString();
+                }
+            }
+        });
+    }
+    auto counters = [&]() {
+        if (!viaJs)
+            return native;
+        QVariantMap js = frame->evaluateJavaScript("bench").toMap();
+        Counters res;
+        res.lines = js["lines"].toULongLong();
+        res.diffs = js["diffs"].toULongLong();
+        res.greeted = js["greeted"].toBool();
+        res.loginMs = js["loginMs"].toDouble();
+        res.error = js["error"].toString().toStdString();
+        return res;
+    };
+
+    // Queue depth is sampled every 10 ms, everything else once the run ends.
+    long rssStart = rssKb(), rssLogin = 0;
+    unsigned long long linesAtLogin = 0, depthSum = 0, depthSamples = 0;
+    unsigned int depthMax = 0;
+    bool loginSent = false;
+    clock_type::time_point loggedIn;
+    QTimer sampler;
+    QObject::connect(&sampler, &QTimer::timeout, [&]() {
+        unsigned int depth = EventScheduler::stats(EventClass::protocol).pending;
+        depthSum += depth;
+        depthSamples++;
+        depthMax = std::max(depthMax, depth);
+        if (loggedIn != clock_type::time_point())
+            return;
+        Counters c = counters();
+        if (!c.error.empty()) {
+            std::fprintf(stderr, "connection failed: %s\n", c.error.c_str());
+            app.exit(1);
+        } else if (c.greeted && !loginSent) {
+            loginSent = true;
+            loginStart = clock_type::now();
+            if (viaJs)
+                frame->evaluateJavaScript("bench.loginStart = Date.now();");
+            lobby.send("LOGIN bench password 0 * lobby_bench\n");
+        } else if (c.loginMs >= 0) {
+            loggedIn = clock_type::now();
+            linesAtLogin = c.lines;
+            rssLogin = rssKb();
+            std::printf("logged in after %.1f ms, %llu lines\n", c.loginMs, c.lines);
+        }
+    });
+    sampler.start(10);
+
+    lobby.connect(host, port, options);
+    QTimer::singleShot(duration * 1000, [&]() {
+        Counters c = counters();
+        auto now = clock_type::now();
+        double loadSec = loggedIn == clock_type::time_point() ? 0 :
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - loggedIn).count() / 1000.0;
+        long rssEnd = rssKb();
+        auto stats = EventScheduler::stats(EventClass::protocol);
+        std::printf("mode: %s%s%s%s%s\n", viaJs ? "js" : "nativeEvents",
+            options["compress"].toBool() ? ", compress" : "", options["tokenize"].toBool() ? ", tokenize" : "",
+            options["batchLogin"].toBool() ? ", batchLogin" : "", options["mirrorState"].toBool() ? ", mirrorState" : "");
+        std::printf("login: %.1f ms\n", c.loginMs);
+        std::printf("lines: %llu total, %.0f/s after login over %.1f s, %llu state diffs\n", c.lines,
+            loadSec > 0 ? (c.lines - linesAtLogin) / loadSec : 0.0, loadSec, c.diffs);
+        std::printf("protocol queue: mean %.2f, max %u events pending, %llu posted, %llu dropped\n",
+            depthSamples ? double(depthSum) / depthSamples : 0.0, depthMax, stats.posted, stats.dropped);
+        std::printf("rss: %ld kB at start, %ld kB after login, %ld kB at the end, %.0f kB/min growth under load\n",
+            rssStart, rssLogin, rssEnd, loadSec > 0 ? (rssEnd - rssLogin) * 60 / loadSec : 0.0);
+        QVariantMap js = lobby.getPerfStats()["jsCalls"].toMap();
+        std::printf("js calls: %llu carrying %llu events, p50 %lld us, p99 %lld us\n", js["count"].toULongLong(),
+            js["items"].toULongLong(), js["p50Us"].toLongLong(), js["p99Us"].toLongLong());
+        app.quit();
+    });
+
+    int exitCode = app.exec();
+    lobby.disconnect();
+    #ifdef Q_OS_LINUX
+        mpg123_exit();
+    #endif
+    curl_global_cleanup();
+    return exitCode;
+}
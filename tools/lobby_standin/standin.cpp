@@ -0,0 +1,233 @@
+// A tiny local stand-in for the lobby server, enough to exercise the
+// client's transport: the greeting, COMPRESS negotiation, PING/PONG, SAY and
+// a login burst of users and battles. After the login it keeps the client
+// busy with status changes, battle joins and leaves, and channel chat at the
+// given rates per second. It frames and compresses with the same LineFramer
+// and DeflateStream the client uses.
+//
+// lobby_standin [-port 8200] [-nocompress] [-users 2000] [-battles 300]
+//               [-churn 0] [-chat 0]
+
+#include "lineframer.h"
+#include "deflatestream.h"
+#include <boost/asio.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+
+static bool allowCompression = true;
+static int userCount = 2000, battleCount = 300;
+static double churnRate = 0, chatRate = 0;
+
+class Session {
+public:
+    explicit Session(tcp::socket socket) : socket(std::move(socket)), compressed(false), running(true),
+        bytesIn(0), wireBytesIn(0), bytesOut(0), wireBytesOut(0) {}
+
+    void run() {
+        try {
+            send({ "TASServer 0.38-33-ga5f3b28 * 8201 0" });
+            std::vector<char> raw(65536);
+            for (;;) {
+                std::size_t n;
+                std::vector<std::string> lines;
+                if (compressed) {
+                    n = socket.read_some(asio::buffer(raw));
+                    unsigned long before = zstream.decompressed();
+                    if (!zstream.decompress(raw.data(), n, framer, lines)) {
+                        std::printf("corrupt stream: %s\n", zstream.error().c_str());
+                        break;
+                    }
+                    bytesIn += zstream.decompressed() - before;
+                    for (auto& line : lines)
+                        handle(line);
+                    lines.clear();
+                } else {
+                    n = socket.read_some(framer.prepare());
+                    framer.commit(n);
+                    bytesIn += n;
+                }
+                wireBytesIn += n;
+                while (framer.extract(lines, 1) > 0)
+                    handle(lines.back());
+            }
+        } catch (boost::system::system_error& e) {
+            if (e.code() != asio::error::eof)
+                std::printf("connection error: %s\n", e.what());
+        }
+        running = false;
+        if (loadThread.joinable())
+            loadThread.join();
+        std::printf("disconnected, %s, in %llu/%llu bytes, out %llu/%llu bytes (protocol/wire)\n",
+            compressed ? "compressed" : "plain", bytesIn, wireBytesIn, bytesOut, wireBytesOut);
+    }
+private:
+    void handle(const std::string& line) {
+        std::string id, cmd = line;
+        if (!cmd.empty() && cmd[0] == '#') {
+            std::size_t sp = cmd.find(' ');
+            id = cmd.substr(0, sp) + " ";
+            cmd = sp == std::string::npos ? "" : cmd.substr(sp + 1);
+        }
+        if (cmd == "COMPRESS deflate") {
+            if (!allowCompression) {
+                send({ "SERVERMSG Unknown command: COMPRESS" });
+                return;
+            }
+            send({ "COMPRESSOK deflate" });
+            std::lock_guard<std::mutex> lock(sendMutex);
+            compressed = true;
+            // Anything after the request is already compressed.
+            std::string rest;
+            framer.drain(rest);
+            bytesIn -= rest.size();
+            std::vector<std::string> lines;
+            zstream.decompress(rest.data(), rest.size(), framer, lines);
+            bytesIn += zstream.decompressed();
+            for (auto& line : lines)
+                handle(line);
+        } else if (cmd.compare(0, 4, "PING") == 0) {
+            send({ id + "PONG" });
+        } else if (cmd.compare(0, 4, "SAY ") == 0) {
+            std::size_t sp = cmd.find(' ', 4);
+            if (sp != std::string::npos)
+                send({ id + "SAID " + cmd.substr(4, sp - 4) + " " + user + cmd.substr(sp) });
+        } else if (cmd.compare(0, 6, "LOGIN ") == 0) {
+            user = cmd.substr(6, cmd.find(' ', 6) - 6);
+            loginBurst(id);
+            if ((churnRate > 0 || chatRate > 0) && !loadThread.joinable())
+                loadThread = std::thread([this]{ generateLoad(); });
+        }
+    }
+
+    void loginBurst(const std::string& id) {
+        std::vector<std::string> lines;
+        lines.push_back(id + "ACCEPTED " + user);
+        lines.push_back("MOTD Welcome to the stand-in lobby server");
+        for (int i = 0; i < userCount; i++) {
+            lines.push_back("ADDUSER Player" + std::to_string(i) + " " + (i % 7 ? "DE" : "US") + " 0 " +
+                std::to_string(100000 + i) + " SpringLobby 0.195");
+        }
+        for (int i = 0; i < battleCount; i++) {
+            lines.push_back("BATTLEOPENED " + std::to_string(i + 1) + " 0 0 Player" + std::to_string(i) +
+                " 192.168.0." + std::to_string(i % 250) + " 8452 16 1 0 -1 Spring 98.0\tDeltaSiegeDry\t"
+                "Team battle " + std::to_string(i) + "\tBalanced Annihilation V7.72\t__battle__" + std::to_string(i));
+            lines.push_back("UPDATEBATTLEINFO " + std::to_string(i + 1) + " 0 0 -1 DeltaSiegeDry");
+        }
+        for (int i = 0; i < userCount; i++)
+            lines.push_back("CLIENTSTATUS Player" + std::to_string(i) + " " + std::to_string(i % 4 ? 0 : 2));
+        lines.push_back("LOGININFOEND");
+        send(lines);
+    }
+
+    // Every 10 ms whatever the rates call for. Every tenth status change is
+    // a battle join or leave instead, with the CLIENTSTATUS that goes along.
+    void generateLoad() {
+        std::minstd_rand random(std::random_device{}());
+        std::vector<int> battleOf(userCount, 0);
+        double churnDue = 0, chatDue = 0;
+        unsigned long long churned = 0, said = 0;
+        auto next = std::chrono::steady_clock::now();
+        while (running) {
+            next += std::chrono::milliseconds(10);
+            std::this_thread::sleep_until(next);
+            churnDue += churnRate / 100;
+            chatDue += chatRate / 100;
+            std::vector<std::string> lines;
+            for (; churnDue >= 1 && userCount > 0; churnDue--, churned++) {
+                int i = random() % userCount;
+                std::string name = "Player" + std::to_string(i);
+                if (churned % 10 == 9 && battleCount > 0) {
+                    if (battleOf[i]) {
+                        lines.push_back("LEFTBATTLE " + std::to_string(battleOf[i]) + " " + name);
+                        battleOf[i] = 0;
+                    } else {
+                        battleOf[i] = 1 + random() % battleCount;
+                        lines.push_back("JOINEDBATTLE " + std::to_string(battleOf[i]) + " " + name);
+                    }
+                }
+                lines.push_back("CLIENTSTATUS " + name + " " + std::to_string(random() % 4 ? 0 : 1 + 2 * (random() % 2)));
+            }
+            for (; chatDue >= 1 && userCount > 0; chatDue--, said++) {
+                lines.push_back("SAID main Player" + std::to_string(random() % userCount) + " message number " +
+                    std::to_string(said) + ", some words to make it look like chat");
+            }
+            if (lines.empty())
+                continue;
+            try {
+                send(lines);
+            } catch (boost::system::system_error&) {
+                break;
+            }
+        }
+        std::printf("load stopped after %llu status changes and %llu chat lines\n", churned, said);
+    }
+
+    // Everything in one write, compressed streams are flushed once per call.
+    // The load thread sends too.
+    void send(const std::vector<std::string>& lines) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        std::string plain;
+        for (auto& line : lines)
+            plain += line + "\n";
+        bytesOut += plain.size();
+        if (compressed) {
+            std::string out;
+            zstream.compress(plain.data(), plain.size(), true, out);
+            wireBytesOut += out.size();
+            asio::write(socket, asio::buffer(out));
+        } else {
+            wireBytesOut += plain.size();
+            asio::write(socket, asio::buffer(plain));
+        }
+    }
+
+    tcp::socket socket;
+    LineFramer framer;
+    DeflateStream zstream;
+    std::atomic<bool> compressed, running;
+    std::string user;
+    std::thread loadThread;
+    std::mutex sendMutex;
+    unsigned long long bytesIn, wireBytesIn, bytesOut, wireBytesOut;
+};
+
+int main(int argc, char** argv) {
+    unsigned short port = 8200;
+    std::setvbuf(stdout, NULL, _IOLBF, 0);
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-port") && i + 1 < argc)
+            port = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-nocompress"))
+            allowCompression = false;
+        else if (!std::strcmp(argv[i], "-users") && i + 1 < argc)
+            userCount = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-battles") && i + 1 < argc)
+            battleCount = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-churn") && i + 1 < argc)
+            churnRate = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "-chat") && i + 1 < argc)
+            chatRate = std::atof(argv[++i]);
+    }
+
+    asio::io_service service;
+    tcp::acceptor acceptor(service, tcp::endpoint(asio::ip::address_v4::loopback(), port));
+    std::printf("listening on %d, compression %s, %d users, %d battles, %g status changes/s, %g chat lines/s\n",
+        port, allowCompression ? "allowed" : "refused", userCount, battleCount, churnRate, chatRate);
+    for (;;) {
+        tcp::socket socket(service);
+        acceptor.accept(socket);
+        std::printf("client connected\n");
+        std::thread([](tcp::socket s) { Session(std::move(s)).run(); }, std::move(socket)).detach();
+    }
+}
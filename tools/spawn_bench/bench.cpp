@@ -0,0 +1,100 @@
+// Launch latency of fork() + exec() through boost::process::execute(), the
+// way ProcessRunner used to start children, against spawnProcess(). The
+// child is sparring_partner from the Boost.Process tests, which exits right
+// away. -heap MB first allocates and touches that much memory, standing in
+// for the QtWebKit heap of the real weblobby process that fork() has to copy
+// the page tables of.
+//
+// spawn_bench [-child ./sparring_partner] [-runs 200] [-heap 512]
+
+#include "processspawn.h"
+#include <boost/process.hpp>
+#include <boost/iostreams/device/file_descriptor.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace process = boost::process;
+typedef std::chrono::steady_clock clock_type;
+
+struct Timing {
+    // Until the launching call returned and until the child was reaped, in us.
+    std::vector<double> launch, total;
+};
+
+static double micros(clock_type::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+static double percentile(std::vector<double> v, double p) {
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, std::size_t(p * v.size()))];
+}
+
+static void report(const char* name, const Timing& t) {
+    double sum = 0;
+    for (double d : t.launch)
+        sum += d;
+    std::printf("%-14s launch mean %8.1f us  p50 %8.1f us  p99 %8.1f us   until reaped p50 %8.1f us\n", name,
+        sum / t.launch.size(), percentile(t.launch, 0.5), percentile(t.launch, 0.99), percentile(t.total, 0.5));
+}
+
+int main(int argc, char** argv) {
+    std::string child = "./sparring_partner";
+    int runs = 200;
+    std::size_t heapMb = 512;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-child") && i + 1 < argc)
+            child = argv[++i];
+        else if (!std::strcmp(argv[i], "-runs") && i + 1 < argc)
+            runs = std::max(std::atoi(argv[++i]), 1);
+        else if (!std::strcmp(argv[i], "-heap") && i + 1 < argc)
+            heapMb = std::atoi(argv[++i]);
+    }
+
+    std::vector<char> heap(heapMb << 20);
+    for (std::size_t i = 0; i < heap.size(); i += 4096)
+        heap[i] = char(i);
+    volatile char keep = heap.empty() ? 0 : heap.back();
+    (void)keep;
+
+    std::vector<std::string> args = { child, "--exit-code", "0" };
+    std::vector<std::string> env = { "PATH=/usr/bin:/bin" };
+    int devNull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    boost::iostreams::file_descriptor_sink sink(devNull, boost::iostreams::never_close_handle);
+
+    Timing forked, spawned;
+    for (int r = 0; r < runs; r++) {
+        using namespace process::initializers;
+        auto start = clock_type::now();
+        auto c = process::execute(set_args(args), set_env(env), bind_stdout(sink), bind_stderr(sink), close_stdin(),
+            throw_on_error());
+        auto launched = clock_type::now();
+        int status;
+        waitpid(c.pid, &status, 0);
+        forked.launch.push_back(micros(launched - start));
+        forked.total.push_back(micros(clock_type::now() - start));
+
+        start = clock_type::now();
+        pid_t pid = spawnProcess(args, env, devNull, devNull);
+        launched = clock_type::now();
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::printf("%s didn't run, exit status %d\n", child.c_str(), status);
+            return 1;
+        }
+        spawned.launch.push_back(micros(launched - start));
+        spawned.total.push_back(micros(clock_type::now() - start));
+    }
+    std::printf("%d runs with a %zu MB heap\n", runs, heapMb);
+    report("fork + exec", forked);
+    report("posix_spawn", spawned);
+    return 0;
+}
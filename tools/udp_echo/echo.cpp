@@ -0,0 +1,87 @@
+// Local stand-ins for game hosts, for trying out the UDP prober: each of
+// ports consecutive ports on 127.0.0.1 echoes every datagram back, port i
+// after delay + i * step ms, dropping the given percentage of them. Ports
+// nothing listens on answer with ICMP port unreachable, as idle hosts do.
+//
+// udp_echo [-port 8452] [-ports 1] [-delay 0] [-step 0] [-drop 0]
+
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace asio = boost::asio;
+using asio::ip::udp;
+
+static int dropPercent = 0;
+static std::minstd_rand dropRandom(42);
+
+class Echo {
+public:
+    Echo(asio::io_service& service, unsigned short port, unsigned int delayMs) : service(service),
+        socket(service, udp::endpoint(asio::ip::address_v4::loopback(), port)), delayMs(delayMs) {}
+
+    void start() {
+        socket.async_receive_from(asio::buffer(buf), from, [this](const boost::system::error_code& ec, std::size_t n){
+            if (!ec && int(dropRandom() % 100) >= dropPercent)
+                reply(std::string(buf.data(), n), from);
+            start();
+        });
+    }
+private:
+    void reply(std::string data, udp::endpoint to) {
+        auto payload = std::make_shared<std::string>(std::move(data));
+        if (!delayMs) {
+            socket.send_to(asio::buffer(*payload), to);
+            return;
+        }
+        auto timer = std::make_shared<asio::steady_timer>(service);
+        timer->expires_from_now(std::chrono::milliseconds(delayMs));
+        timer->async_wait([this, timer, payload, to](const boost::system::error_code&){
+            boost::system::error_code ec;
+            socket.send_to(asio::buffer(*payload), to, 0, ec);
+        });
+    }
+
+    asio::io_service& service;
+    udp::socket socket;
+    unsigned int delayMs;
+    std::array<char, 2048> buf;
+    udp::endpoint from;
+};
+
+int main(int argc, char** argv) {
+    unsigned short port = 8452;
+    int ports = 1;
+    unsigned int delay = 0, step = 0;
+    std::setvbuf(stdout, NULL, _IOLBF, 0);
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-port") && i + 1 < argc)
+            port = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-ports") && i + 1 < argc)
+            ports = std::max(std::atoi(argv[++i]), 1);
+        else if (!std::strcmp(argv[i], "-delay") && i + 1 < argc)
+            delay = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-step") && i + 1 < argc)
+            step = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-drop") && i + 1 < argc)
+            dropPercent = std::atoi(argv[++i]);
+    }
+
+    asio::io_service service;
+    std::vector<std::unique_ptr<Echo>> echoes;
+    for (int i = 0; i < ports; i++) {
+        echoes.emplace_back(new Echo(service, port + i, delay + i * step));
+        echoes.back()->start();
+    }
+    std::printf("echoing on %d-%d, %u ms + %u ms per port, dropping %d%%\n", port, port + ports - 1, delay, step,
+        dropPercent);
+    service.run();
+}
@@ -53,13 +53,14 @@ putTemplate funcs "public_methods_definitions_async" = concat $ flip map (onlyKn
      "    }",
      "    boost::unique_lock<boost::mutex> lock(queueMutex);",
      "    queue.push([=](){",
+     "        TraceSpan span(\"unitsync " <> name <> "\");",
      "        logger.debug(\"call " <> name <> "(\", " <> commaList (intersperse "\", \"" callArgs) <>
                 (if null callArgs then "" else ", ") <> "\")\");",
      "        " <> case ret of
                     (CVoid) -> ""
                     typ -> showCType typ <> " res = "
                 <> "fptr_" <> name <> "(" <> commaList callArgs <> ")" <> ";",
-     "        QCoreApplication::postEvent(parent(), new ResultEvent(__id.toStdString(), \"" <> showCType ret <> "\", " <>
+     "        EventScheduler::post(parent(), new ResultEvent(__id.toStdString(), \"" <> showCType ret <> "\", " <>
                 marshallAsString ret "res" <> "));",
      "    });",
      "    queueCond.notify_all();",
@@ -118,6 +119,7 @@ putTemplate funcs "public_methods_definitions" = concat $ flip map (onlyKnown fu
      "        logger.error(\"Bad function pointer: " <> name <> "\");",
      "        throw bad_fptr(\"" <> name <> "\");",
      "    }",
+     "    Activity activity(\"unitsync " <> name <> "\");",
      "    logger.debug(\"call " <> name <> "(\", " <> commaList (intersperse "\", \"" callArgs) <>
             (if null callArgs then "" else ", ") <> "\")\");",
      "    return " <> marshallOut (getExternalRep ret) ("fptr_" <> name <> "(" <> commaList callArgs <> ")") <> ";",
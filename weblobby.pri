@@ -0,0 +1,70 @@
+# Everything but main() and the window, shared by weblobby.pro and lobby_bench.pro.
+
+# Qt 5 only, signals are connected to member functions and lambdas.
+lessThan(QT_MAJOR_VERSION, 5):error("weblobby needs Qt 5")
+QT += widgets webkitwidgets
+win32:QT += multimedia
+CONFIG += c++11
+unix:CONFIG += debug
+
+SOURCES += \
+    $$PWD/src/lobbyinterface.cpp \
+    $$PWD/src/networkhandler.cpp \
+    $$PWD/src/nativeevent.cpp \
+    $$PWD/src/perfstats.cpp \
+    $$PWD/src/watchdog.cpp \
+    $$PWD/src/trace.cpp \
+    $$PWD/src/consolefilter.cpp \
+    $$PWD/src/lineframer.cpp \
+    $$PWD/src/deflatestream.cpp \
+    $$PWD/src/endpointcache.cpp \
+    $$PWD/src/lobbyprotocol.cpp \
+    $$PWD/src/lobbystate.cpp \
+    $$PWD/src/sessioncapture.cpp \
+    $$PWD/src/protocolprofiler.cpp \
+    $$PWD/src/udpprober.cpp \
+    $$PWD/src/unitsynchandler.cpp \
+    $$PWD/src/unitsynchandler_t.cpp \
+    $$PWD/src/processreaper.cpp \
+    $$PWD/src/processspawn.cpp \
+    $$PWD/src/processrunner.cpp
+
+HEADERS += \
+    $$PWD/src/lobbyinterface.h \
+    $$PWD/src/logger.h \
+    $$PWD/src/nativeevent.h \
+    $$PWD/src/perfstats.h \
+    $$PWD/src/watchdog.h \
+    $$PWD/src/trace.h \
+    $$PWD/src/consolefilter.h \
+    $$PWD/src/lineframer.h \
+    $$PWD/src/deflatestream.h \
+    $$PWD/src/endpointcache.h \
+    $$PWD/src/lobbyprotocol.h \
+    $$PWD/src/lobbystate.h \
+    $$PWD/src/sessioncapture.h \
+    $$PWD/src/protocolprofiler.h \
+    $$PWD/src/udpprober.h \
+    $$PWD/src/processreaper.h \
+    $$PWD/src/processspawn.h \
+    $$PWD/src/escapejs.h \
+    $$PWD/src/ufstream.h\
+    $$PWD/src/unitsynchandler.h\
+    $$PWD/src/unitsynchandler_t.h
+
+INCLUDEPATH += $$PWD/src $$PWD/Boost.Process-0.5
+
+unix:!macx {
+    LIBS += -ldl -lboost_filesystem -lboost_system -lboost_thread -lboost_iostreams -lboost_chrono -lcurl -lz -lmpg123 -lasound
+}
+win32 {
+    LIBS += -Ld:/mingw32/lib -lboost_filesystem-mgw48-mt-1_55 -lboost_system-mgw48-mt-1_55 -lboost_thread-mgw48-mt-1_55 -lboost_iostreams-mgw48-mt-1_55 -lboost_chrono-mgw48-mt-1_55
+    LIBS += -lws2_32 -lwsock32 -lpsapi -lcurl -lz
+    LIBS += -Wl,-subsystem,console -mconsole
+}
+macx {
+    QT += multimedia webkit
+    INCLUDEPATH += /opt/local/include
+    LIBS += -L /opt/local/lib
+    LIBS += -lboost_filesystem-mt -lboost_system-mt -lboost_thread-mt -lboost_iostreams-mt -lboost_chrono-mt -lcurl -lz -ldl
+}